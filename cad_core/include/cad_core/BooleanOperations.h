@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cad_core/Shape.h"
+#include <TopTools_ListOfShape.hxx>
 #include <vector>
 
 namespace cad_core {
@@ -22,11 +23,28 @@ public:
     static ShapePtr Intersection(const std::vector<ShapePtr>& shapes);
     
     static ShapePtr Difference(const ShapePtr& shape1, const ShapePtr& shape2);
+    static ShapePtr Difference(const ShapePtr& target, const std::vector<ShapePtr>& tools);
+    static ShapePtr Difference(const std::vector<ShapePtr>& targets, const std::vector<ShapePtr>& tools);
     
     // 通用布尔运算
     static ShapePtr BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type);
     static ShapePtr BooleanOperation(const std::vector<ShapePtr>& shapes, BooleanType type);
     
+    // 多参数布尔运算：所有对象和工具一次性交给General Fuse求交，不再两两折叠
+    static ShapePtr BooleanOperation(const std::vector<ShapePtr>& arguments,
+                                     const std::vector<ShapePtr>& tools, BooleanType type);
+    
+    // 并行模式（默认开启，使用OCCT线程池占满所有核心）
+    static void SetRunParallel(bool runParallel);
+    static bool IsRunParallel();
+    
+    // 包围盒预筛选是否额外使用有向包围盒（默认只用轴对齐包围盒）
+    static void SetUseOrientedBoundingBox(bool useOriented);
+    static bool IsUseOrientedBoundingBox();
+    
+    // 包围盒预筛选：false表示两个形状一定不接触，可以跳过求交
+    static bool MayOverlap(const ShapePtr& shape1, const ShapePtr& shape2);
+    
     // 验证形状是否有效
     static bool IsValidShape(const ShapePtr& shape);
     
@@ -41,10 +59,25 @@ private:
     static ShapePtr PerformUnion(const ShapePtr& shape1, const ShapePtr& shape2);
     static ShapePtr PerformIntersection(const ShapePtr& shape1, const ShapePtr& shape2);
     static ShapePtr PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2);
+    static ShapePtr PerformMultiple(const std::vector<ShapePtr>& arguments,
+                                    const std::vector<ShapePtr>& tools, BooleanType type);
+    static ShapePtr PerformMultipleIntersection(const std::vector<ShapePtr>& shapes);
     
     // 形状验证和修复
     static bool ValidateInputs(const ShapePtr& shape1, const ShapePtr& shape2);
     static ShapePtr PostProcessResult(const TopoDS_Shape& result);
+    static bool CollectShapes(const std::vector<ShapePtr>& shapes, TopTools_ListOfShape& list);
+    
+    // 包围盒快速路径
+    static bool AllDisjoint(const std::vector<ShapePtr>& shapes);
+    static bool AnyDisjoint(const std::vector<ShapePtr>& shapes);
+    static std::vector<ShapePtr> FilterTouchingTools(const std::vector<ShapePtr>& targets,
+                                                     const std::vector<ShapePtr>& tools);
+    static ShapePtr MakeCompound(const std::vector<ShapePtr>& shapes);
+    static ShapePtr MakeEmptyResult();
+    
+    static bool s_runParallel;
+    static bool s_useOrientedBoundingBox;
 };
 
 } // namespace cad_core
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <GProp_GProps.hxx>
+#include <vector>
+
+namespace cad_core {
+
+class MassPropertyService {
+public:
+    // 积分精度：0表示使用BRepGProp默认的非自适应高斯积分，
+    // 大于0表示自适应积分的相对误差，越大越快
+    static constexpr double DEFAULT_TOLERANCE = 0.0;
+    static constexpr double ESTIMATE_TOLERANCE = 1.0e-2;
+    static constexpr double PRECISE_TOLERANCE = 1.0e-6;
+    
+    struct Options {
+        double tolerance = DEFAULT_TOLERANCE;
+        bool runParallel = true;
+    };
+    
+    struct Result {
+        GProp_GProps volumeProps;
+        GProp_GProps surfaceProps;
+        
+        // 自适应积分时的误差估计（各部分的最大值），非自适应时为0
+        double volumeError = 0.0;
+        double areaError = 0.0;
+    };
+    
+    // 体积按实体拆分、面积按面拆分，在OCCT线程池上并行积分，
+    // 再按固定顺序归约，多次运行结果逐位相同
+    static Result Compute(const TopoDS_Shape& shape, const Options& options = Options());
+    
+private:
+    static void CollectVolumeItems(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& items);
+    static void CollectSurfaceItems(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& items);
+};
+
+} // namespace cad_core
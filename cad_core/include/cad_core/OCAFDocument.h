@@ -12,12 +12,28 @@
 #include <TCollection_AsciiString.hxx>
 #include <XCAFDoc_ShapeTool.hxx>
 #include <XCAFDoc_DocumentTool.hxx>
+#include <TDF_Delta.hxx>
+#include <TDF_LabelMapHasher.hxx>
+#include <TDF_LabelMap.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
+#include <NCollection_DataMap.hxx>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "cad_core/Shape.h"
 
 namespace cad_core {
 
+// 一次撤销/重做对形状造成的变化，取自该事务的TDF_Delta，UI只需处理这些形状
+struct ShapeChanges {
+    std::vector<ShapePtr> added;
+    std::vector<ShapePtr> removed;
+    std::vector<std::pair<ShapePtr, ShapePtr>> modified;  // 旧形状, 新形状
+    
+    bool IsEmpty() const { return added.empty() && removed.empty() && modified.empty(); }
+};
+
 class OCAFDocument {
 public:
     OCAFDocument();
@@ -37,6 +53,13 @@ public:
     ShapePtr GetShape(const TDF_Label& label) const;
     std::vector<TDF_Label> GetAllShapes() const;
     
+    // GetShape对同一标签、同一命名形状版本总是返回同一个ShapePtr，
+    // 视图、文档树和各种缓存可以直接用指针比较，撤销/重做后依然有效
+    
+    // 形状到标签的索引查找（按TShape+Location，即IsSame语义），O(1)
+    TDF_Label FindLabel(const ShapePtr& shape) const;
+    TDF_Label FindLabel(const TopoDS_Shape& shape) const;
+    
     // 树操作
     TDF_Label CreateFolder(const std::string& name, const TDF_Label& parent = TDF_Label());
     bool MoveShape(const TDF_Label& shape, const TDF_Label& newParent);
@@ -54,6 +77,7 @@ public:
     bool Redo();
     bool CanUndo() const;
     bool CanRedo() const;
+    const ShapeChanges& GetLastChanges() const { return m_lastChanges; }
     void StartTransaction(const std::string& name = "Operation");
     void CommitTransaction();
     void AbortTransaction();
@@ -74,10 +98,32 @@ private:
     bool m_isInitialized;
     bool m_inTransaction;
     
+    // 形状索引：形状 -> 标签，以及反向的标签 -> 已索引形状
+    // 增删时直接维护；撤销/重做只重建该事务涉及的标签；中止事务重建本事务改过的标签
+    NCollection_DataMap<TopoDS_Shape, TDF_Label, TopTools_ShapeMapHasher> m_shapeIndex;
+    NCollection_DataMap<TDF_Label, TopoDS_Shape, TDF_LabelMapHasher> m_labelIndex;
+    TDF_LabelMap m_transactionLabels;
+    ShapeChanges m_lastChanges;
+    
+    // 形状注册表：标签 -> 已发放的ShapePtr。删除时保留，撤销删除后还能拿回原来的指针
+    struct RegisteredShape {
+        ShapePtr shape;
+        int version = 0;
+    };
+    mutable NCollection_DataMap<TDF_Label, RegisteredShape, TDF_LabelMapHasher> m_shapeRegistry;
+    
     // 辅助方法
     void InitializeApplication();
     void InitializeDocument();
     TDF_Label GetNextAvailableLabel(const TDF_Label& parent);
+    
+    // 索引维护
+    void RebuildShapeIndex();
+    void ReindexLabel(const TDF_Label& label);
+    void ReindexDelta(const Handle(TDF_Delta)& delta);
+    void IndexShape(const TDF_Label& label, const TopoDS_Shape& shape);
+    void UnindexLabel(const TDF_Label& label);
+    void RegisterShape(const TDF_Label& label, const ShapePtr& shape) const;
 };
 
 } // namespace cad_core
\ No newline at end of file
@@ -36,6 +36,9 @@ public:
     bool CanUndo() const;
     bool CanRedo() const;
     
+    // 最近一次撤销/重做改动了哪些形状
+    ShapeChanges GetLastChanges() const;
+    
     // 事务操作
     void StartTransaction(const std::string& name = "Operation");
     void CommitTransaction();
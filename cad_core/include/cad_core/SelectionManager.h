@@ -47,6 +47,11 @@ public:
     void SetSelectionMode(SelectionMode mode);
     SelectionMode GetSelectionMode() const { return m_currentMode; }
     
+    // 延迟激活子形状模式：面/边/顶点模式不再对所有对象全局激活，
+    // 由视图按需对光标下的对象单独激活
+    void SetLazySubShapeActivation(bool lazy) { m_lazySubShapeActivation = lazy; }
+    bool IsLazySubShapeActivation() const { return m_lazySubShapeActivation; }
+    
     // 选择操作
     void StartSelection(int x, int y);
     void UpdateSelection(int x, int y);
@@ -84,6 +89,7 @@ private:
     Handle(AIS_InteractiveContext) m_context;
     Handle(V3d_View) m_view;
     SelectionMode m_currentMode;
+    bool m_lazySubShapeActivation;
     std::vector<SelectionInfo> m_selectedItems;
     
     // 私有方法
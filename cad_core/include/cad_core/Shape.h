@@ -5,14 +5,18 @@
  * 这个类封装了OpenCASCADE的TopoDS_Shape，让我们能够更优雅地处理几何体
  * 不得不说OpenCASCADE的命名真的很有特色...TopoDS是什么鬼名字？😅
  * 
- * TODO: 添加更多几何属性计算（重心、包围盒等）
+ * 几何属性（体积、面积、重心、惯性矩、包围盒、拓扑计数）统一缓存在ShapeProperties里
  * TODO: 考虑添加形状变换功能
  * TODO: 实现形状的序列化和反序列化
  */
 
 #pragma once
 
+#include "cad_core/ShapeProperties.h"
 #include <TopoDS_Shape.hxx>
+#include <Bnd_Box.hxx>
+#include <Bnd_OBB.hxx>
+#include <future>
 #include <memory>
 
 
@@ -57,9 +61,13 @@ public:
      */
     bool IsValid() const;
     
+    /** 属性缓存的共享指针 - 形状换了内核，旧的快照依然有效 */
+    using PropertiesPtr = std::shared_ptr<const ShapeProperties>;
+    
     /** 
      * 计算体积 - 让我们看看这个形状能装多少"水"
      * @return 体积值，单位取决于你的建模单位
+     * 结果来自属性缓存，第一次调用才真正计算
      * TODO: 添加单位处理和错误检查
      */
     double Volume() const;
@@ -70,10 +78,70 @@ public:
      * TODO: 对于非封闭形状可能需要特殊处理
      */
     double Area() const;
+    
+    /** 
+     * 获取全部几何属性 - 按需计算，之后直接返回缓存
+     * 如果后台计算正在进行，会等它算完而不是重算一遍
+     * @return 属性快照，永不为空
+     */
+    PropertiesPtr GetProperties() const;
+    
+    /** 
+     * 只读缓存，绝不阻塞 - 给UI线程用的
+     * @return 已经算好的属性，还没算好就返回nullptr
+     */
+    PropertiesPtr GetCachedProperties() const;
+    
+    /** 
+     * 获取快速估算值 - 后台任务会先用低精度算一遍，方便UI先显示个大概
+     * @return 估算值，还没算好就返回nullptr
+     */
+    PropertiesPtr GetEstimatedProperties() const;
+    
+    /** 
+     * 在后台线程计算属性 - 先出估算值，再出精确值；多次调用共享同一个计算任务
+     * @return 可以轮询的future（对应精确值），算好后结果也会写进缓存
+     */
+    std::shared_future<PropertiesPtr> ComputePropertiesAsync() const;
+    
+    /** 
+     * 获取轴对齐包围盒 - 第一次调用时计算，之后直接用缓存
+     * @return 包围盒，SetOCCTShape之后会重新计算
+     */
+    const Bnd_Box& GetBoundingBox() const;
+    
+    /** 
+     * 获取有向包围盒 - 比轴对齐包围盒更紧，但计算也更贵，同样按需缓存
+     * @return 有向包围盒
+     */
+    const Bnd_OBB& GetOrientedBoundingBox() const;
+    
+    /** 
+     * 判断两个形状的包围盒是否相交 - 布尔运算前的廉价预筛选
+     * @param other 另一个形状
+     * @param useOriented 轴对齐包围盒相交时是否再用有向包围盒复查
+     * @return false表示两者一定不接触，true表示可能接触
+     */
+    bool BoundingBoxOverlaps(const Shape& other, bool useOriented = false) const;
 
 private:
+    /** 属性缓存的内部状态，定义在Shape.cpp里 */
+    struct PropertyCache;
+    
     /** 存储实际的OpenCASCADE形状 - 我们的"内核" */
     TopoDS_Shape m_shape;
+    
+    /** 
+     * 属性缓存 - SetOCCTShape时整个换新，正在运行的后台任务
+     * 只会写进旧缓存，不会污染新形状
+     */
+    std::shared_ptr<PropertyCache> m_propertyCache;
+    
+    /** 包围盒缓存 - mutable是因为缓存不改变形状的"外在表现" */
+    mutable Bnd_Box m_boundingBox;
+    mutable Bnd_OBB m_orientedBoundingBox;
+    mutable bool m_hasBoundingBox = false;
+    mutable bool m_hasOrientedBoundingBox = false;
 };
 
 /** 智能指针类型别名 - 现代C++的标配，内存管理不用愁 */
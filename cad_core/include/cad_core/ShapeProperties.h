@@ -0,0 +1,39 @@
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <Bnd_Box.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Mat.hxx>
+
+namespace cad_core {
+
+// 形状的几何属性快照 - 一次算完，整体缓存在Shape上
+struct ShapeProperties {
+    // 质量属性
+    double volume = 0.0;
+    double area = 0.0;
+    gp_Pnt centroid;
+    gp_Mat inertia;
+    
+    // 包围盒
+    Bnd_Box boundingBox;
+    
+    // 拓扑计数（去重后的子形状数量）
+    int solidCount = 0;
+    int shellCount = 0;
+    int faceCount = 0;
+    int edgeCount = 0;
+    int vertexCount = 0;
+    
+    // 是否为快速估算值（自适应积分，精度较低），精确值算完后会替换它
+    bool isEstimate = false;
+    
+    // 计算所有属性，可在任意线程调用
+    // tolerance含义见MassPropertyService，0为默认精度
+    static ShapeProperties Compute(const TopoDS_Shape& shape, double tolerance = 0.0);
+    
+    // 按新的精度只重算质量属性，包围盒和拓扑计数沿用当前值（它们与精度无关）
+    ShapeProperties Refine(const TopoDS_Shape& shape, double tolerance) const;
+};
+
+} // namespace cad_core
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "cad_core/Shape.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cad_core {
+
+// 后台网格划分服务：在工作线程上运行BRepMesh_IncrementalMesh，
+// 每个形状内部再按面并行。回调在工作线程上执行，调用方负责切回UI线程
+class TessellationService {
+public:
+    using Callback = std::function<void(const ShapePtr& shape, bool success)>;
+    
+    // threadCount为0时按硬件线程数的一半分配（面级并行还会用到OCCT线程池）
+    explicit TessellationService(unsigned int threadCount = 0);
+    ~TessellationService();
+    
+    TessellationService(const TessellationService&) = delete;
+    TessellationService& operator=(const TessellationService&) = delete;
+    
+    // 提交网格划分任务，deflection为绝对弦高，angle为弧度
+    void Submit(const ShapePtr& shape, double linearDeflection, double angularDeflection, Callback callback);
+    
+    // 取消尚未开始的任务（已经在算的任务照常完成）
+    void Cancel(const ShapePtr& shape);
+    void CancelAll();
+    
+    size_t PendingCount() const;
+    
+    // 同步划分网格，可在任意线程调用
+    static bool Tessellate(const TopoDS_Shape& shape, double linearDeflection, double angularDeflection);
+    
+private:
+    struct Task {
+        ShapePtr shape;
+        double linearDeflection;
+        double angularDeflection;
+        Callback callback;
+    };
+    
+    void WorkerLoop();
+    
+    std::vector<std::thread> m_workers;
+    std::deque<Task> m_tasks;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+};
+
+} // namespace cad_core
@@ -37,17 +37,42 @@ public:
     // 获取变换后的形状（用于预览）
     std::vector<ShapePtr> GetTransformedShapes() const;
     
+    const std::vector<ShapePtr>& GetOriginalShapes() const { return m_originalShapes; }
+    
+    // 变换矩阵，以及每个结果相对原对象的放置（复制模式下第k个为k次变换）。
+    // 实时预览直接把它们设到已有显示对象上，不生成几何
+    gp_Trsf GetTransformation() const { return CreateTransformation(); }
+    std::vector<gp_Trsf> GetPlacements() const;
+    
     // 设置变换参数（由派生类具体实现）
     virtual void SetTransformParameters() = 0;
     
+    // 复制/阵列模式：保留原对象，生成count个副本，第k个副本应用k次变换。
+    // count为0时为普通变换（替换原对象）。
+    // 刚体变换的结果和副本都只改变TopLoc_Location，与原对象共享同一个
+    // TopoDS_TShape（以及网格），显示时也只占一份网格
+    void SetCopyCount(int count);
+    int GetCopyCount() const { return m_copyCount; }
+    bool IsCopyMode() const { return m_copyCount > 0; }
+    
 protected:
     virtual gp_Trsf CreateTransformation() const = 0;
     virtual const char* GetTypeName() const = 0;
+    
+    // 变换能否只用位置（TopLoc_Location）表示，不改动几何。
+    // 平移、旋转为刚体变换；缩放必须改写几何
+    virtual bool IsRigidTransformation() const { return true; }
 
     std::vector<ShapePtr> m_originalShapes;
     std::vector<ShapePtr> m_transformedShapes;
     TransformationType m_type;
     bool m_executed;
+    int m_copyCount;
+    
+private:
+    std::vector<ShapePtr> ComputeTransformedShapes() const;
+    ShapePtr PlaceShape(const ShapePtr& shape, const gp_Trsf& placement) const;
+    static bool IsLocationTransformation(const gp_Trsf& transformation);
 };
 
 /**
@@ -117,6 +142,7 @@ public:
 protected:
     gp_Trsf CreateTransformation() const override;
     const char* GetTypeName() const override;
+    bool IsRigidTransformation() const override { return false; }
 
 private:
     Point m_centerPoint;
@@ -2,15 +2,47 @@
 #include <BRepAlgoAPI_Fuse.hxx>
 #include <BRepAlgoAPI_Common.hxx>
 #include <BRepAlgoAPI_Cut.hxx>
+#include <BRepAlgoAPI_BooleanOperation.hxx>
+#include <BOPAlgo_CellsBuilder.hxx>
 #include <BRepCheck_Analyzer.hxx>
 #include <ShapeFix_Shape.hxx>
 #include <BRepBuilderAPI_MakeShape.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <BRep_Builder.hxx>
 #include <Standard_Failure.hxx>
 
 namespace cad_core {
 
+bool BooleanOperations::s_runParallel = true;
+bool BooleanOperations::s_useOrientedBoundingBox = false;
+
+void BooleanOperations::SetRunParallel(bool runParallel) {
+    s_runParallel = runParallel;
+}
+
+bool BooleanOperations::IsRunParallel() {
+    return s_runParallel;
+}
+
+void BooleanOperations::SetUseOrientedBoundingBox(bool useOriented) {
+    s_useOrientedBoundingBox = useOriented;
+}
+
+bool BooleanOperations::IsUseOrientedBoundingBox() {
+    return s_useOrientedBoundingBox;
+}
+
+bool BooleanOperations::MayOverlap(const ShapePtr& shape1, const ShapePtr& shape2) {
+    // 无效输入交给后面的校验处理，这里不下结论
+    if (!shape1 || !shape2 || shape1->GetOCCTShape().IsNull() || shape2->GetOCCTShape().IsNull()) {
+        return true;
+    }
+    
+    return shape1->BoundingBoxOverlaps(*shape2, s_useOrientedBoundingBox);
+}
+
 ShapePtr BooleanOperations::Union(const ShapePtr& shape1, const ShapePtr& shape2) {
     return PerformUnion(shape1, shape2);
 }
@@ -19,13 +51,14 @@ ShapePtr BooleanOperations::Union(const std::vector<ShapePtr>& shapes) {
     if (shapes.empty()) return nullptr;
     if (shapes.size() == 1) return shapes[0];
     
-    ShapePtr result = shapes[0];
-    for (size_t i = 1; i < shapes.size(); i++) {
-        result = Union(result, shapes[i]);
-        if (!result) return nullptr;
+    // 互不接触时直接打包成复合体，不做任何求交
+    if (AllDisjoint(shapes)) {
+        return MakeCompound(shapes);
     }
     
-    return result;
+    // 第一个形状作为对象，其余全部作为工具，一次求交完成
+    std::vector<ShapePtr> tools(shapes.begin() + 1, shapes.end());
+    return PerformMultiple({shapes[0]}, tools, BooleanType::Union);
 }
 
 ShapePtr BooleanOperations::Intersection(const ShapePtr& shape1, const ShapePtr& shape2) {
@@ -35,20 +68,40 @@ ShapePtr BooleanOperations::Intersection(const ShapePtr& shape1, const ShapePtr&
 ShapePtr BooleanOperations::Intersection(const std::vector<ShapePtr>& shapes) {
     if (shapes.empty()) return nullptr;
     if (shapes.size() == 1) return shapes[0];
+    if (shapes.size() == 2) return PerformIntersection(shapes[0], shapes[1]);
     
-    ShapePtr result = shapes[0];
-    for (size_t i = 1; i < shapes.size(); i++) {
-        result = Intersection(result, shapes[i]);
-        if (!result) return nullptr;
+    // 只要有一对互不接触，交集必然为空
+    if (AnyDisjoint(shapes)) {
+        return MakeEmptyResult();
     }
     
-    return result;
+    return PerformMultipleIntersection(shapes);
 }
 
 ShapePtr BooleanOperations::Difference(const ShapePtr& shape1, const ShapePtr& shape2) {
     return PerformDifference(shape1, shape2);
 }
 
+ShapePtr BooleanOperations::Difference(const ShapePtr& target, const std::vector<ShapePtr>& tools) {
+    // 碰不到目标的工具先剔除，不交给内核
+    std::vector<ShapePtr> touchingTools = FilterTouchingTools({target}, tools);
+    if (touchingTools.empty()) return target;
+    if (touchingTools.size() == 1) return PerformDifference(target, touchingTools[0]);
+    
+    return PerformMultiple({target}, touchingTools, BooleanType::Difference);
+}
+
+ShapePtr BooleanOperations::Difference(const std::vector<ShapePtr>& targets, const std::vector<ShapePtr>& tools) {
+    if (targets.empty()) return nullptr;
+    if (targets.size() == 1) return Difference(targets[0], tools);
+    
+    // 没有工具碰到任何目标时，各目标原样放进复合体，不做任何内核计算
+    std::vector<ShapePtr> touchingTools = FilterTouchingTools(targets, tools);
+    if (touchingTools.empty()) return MakeCompound(targets);
+    
+    return PerformMultiple(targets, touchingTools, BooleanType::Difference);
+}
+
 ShapePtr BooleanOperations::BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type) {
     switch (type) {
         case BooleanType::Union:
@@ -69,9 +122,9 @@ ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& shapes
         case BooleanType::Intersection:
             return Intersection(shapes);
         case BooleanType::Difference:
-            // 对于差集操作，我们只能处理两个形状
-            if (shapes.size() == 2) {
-                return Difference(shapes[0], shapes[1]);
+            // 第一个形状减去其余所有形状
+            if (shapes.size() >= 2) {
+                return Difference(shapes[0], std::vector<ShapePtr>(shapes.begin() + 1, shapes.end()));
             }
             return nullptr;
         default:
@@ -79,6 +132,23 @@ ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& shapes
     }
 }
 
+ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& arguments,
+                                             const std::vector<ShapePtr>& tools, BooleanType type) {
+    std::vector<ShapePtr> allShapes = arguments;
+    allShapes.insert(allShapes.end(), tools.begin(), tools.end());
+    
+    switch (type) {
+        case BooleanType::Union:
+            return Union(allShapes);
+        case BooleanType::Intersection:
+            return Intersection(allShapes);
+        case BooleanType::Difference:
+            return Difference(arguments, tools);
+        default:
+            return nullptr;
+    }
+}
+
 bool BooleanOperations::IsValidShape(const ShapePtr& shape) {
     if (!shape || shape->GetOCCTShape().IsNull()) {
         return false;
@@ -124,6 +194,11 @@ ShapePtr BooleanOperations::PerformUnion(const ShapePtr& shape1, const ShapePtr&
         return nullptr;
     }
     
+    // 包围盒不相交：结果就是两者的复合体
+    if (!MayOverlap(shape1, shape2)) {
+        return MakeCompound({shape1, shape2});
+    }
+    
     try {
         BRepAlgoAPI_Fuse fuseOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
         fuseOp.Build();
@@ -144,6 +219,11 @@ ShapePtr BooleanOperations::PerformIntersection(const ShapePtr& shape1, const Sh
         return nullptr;
     }
     
+    // 包围盒不相交：交集为空
+    if (!MayOverlap(shape1, shape2)) {
+        return MakeEmptyResult();
+    }
+    
     try {
         BRepAlgoAPI_Common commonOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
         commonOp.Build();
@@ -164,6 +244,11 @@ ShapePtr BooleanOperations::PerformDifference(const ShapePtr& shape1, const Shap
         return nullptr;
     }
     
+    // 包围盒不相交：目标原样返回
+    if (!MayOverlap(shape1, shape2)) {
+        return shape1;
+    }
+    
     try {
         BRepAlgoAPI_Cut cutOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
         cutOp.Build();
@@ -179,6 +264,138 @@ ShapePtr BooleanOperations::PerformDifference(const ShapePtr& shape1, const Shap
     return nullptr;
 }
 
+ShapePtr BooleanOperations::PerformMultiple(const std::vector<ShapePtr>& arguments,
+                                            const std::vector<ShapePtr>& tools, BooleanType type) {
+    TopTools_ListOfShape argumentList;
+    TopTools_ListOfShape toolList;
+    if (!CollectShapes(arguments, argumentList) || !CollectShapes(tools, toolList)) {
+        return nullptr;
+    }
+    
+    try {
+        // 对象和工具一起交给General Fuse，只做一次相交计算
+        BRepAlgoAPI_BooleanOperation booleanOp;
+        booleanOp.SetOperation(type == BooleanType::Union ? BOPAlgo_FUSE : BOPAlgo_CUT);
+        booleanOp.SetArguments(argumentList);
+        booleanOp.SetTools(toolList);
+        booleanOp.SetRunParallel(s_runParallel);
+        booleanOp.Build();
+        
+        if (booleanOp.IsDone()) {
+            TopoDS_Shape result = booleanOp.Shape();
+            return PostProcessResult(result);
+        }
+    } catch (const Standard_Failure& e) {
+        // 布尔运算失败
+    }
+    
+    return nullptr;
+}
+
+ShapePtr BooleanOperations::PerformMultipleIntersection(const std::vector<ShapePtr>& shapes) {
+    TopTools_ListOfShape shapeList;
+    if (!CollectShapes(shapes, shapeList)) {
+        return nullptr;
+    }
+    
+    try {
+        // BRepAlgoAPI_Common对分组求的是(∪对象)∩(∪工具)，N元交集要用CellsBuilder
+        // 一次分割后只取位于所有参数内部的单元
+        BOPAlgo_CellsBuilder cellsBuilder;
+        cellsBuilder.SetArguments(shapeList);
+        cellsBuilder.SetRunParallel(s_runParallel);
+        cellsBuilder.Perform();
+        
+        if (!cellsBuilder.HasErrors()) {
+            TopTools_ListOfShape avoidList;
+            cellsBuilder.AddToResult(shapeList, avoidList, 1);
+            cellsBuilder.RemoveInternalBoundaries();
+            
+            TopoDS_Shape result = cellsBuilder.Shape();
+            return PostProcessResult(result);
+        }
+    } catch (const Standard_Failure& e) {
+        // 布尔运算失败
+    }
+    
+    return nullptr;
+}
+
+bool BooleanOperations::CollectShapes(const std::vector<ShapePtr>& shapes, TopTools_ListOfShape& list) {
+    for (const auto& shape : shapes) {
+        if (!shape || shape->GetOCCTShape().IsNull()) {
+            return false;
+        }
+        list.Append(shape->GetOCCTShape());
+    }
+    
+    return true;
+}
+
+bool BooleanOperations::AllDisjoint(const std::vector<ShapePtr>& shapes) {
+    for (size_t i = 0; i < shapes.size(); i++) {
+        for (size_t j = i + 1; j < shapes.size(); j++) {
+            if (MayOverlap(shapes[i], shapes[j])) {
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+bool BooleanOperations::AnyDisjoint(const std::vector<ShapePtr>& shapes) {
+    for (size_t i = 0; i < shapes.size(); i++) {
+        for (size_t j = i + 1; j < shapes.size(); j++) {
+            if (!MayOverlap(shapes[i], shapes[j])) {
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+std::vector<ShapePtr> BooleanOperations::FilterTouchingTools(const std::vector<ShapePtr>& targets,
+                                                             const std::vector<ShapePtr>& tools) {
+    std::vector<ShapePtr> touchingTools;
+    touchingTools.reserve(tools.size());
+    
+    for (const auto& tool : tools) {
+        for (const auto& target : targets) {
+            if (MayOverlap(target, tool)) {
+                touchingTools.push_back(tool);
+                break;
+            }
+        }
+    }
+    
+    return touchingTools;
+}
+
+ShapePtr BooleanOperations::MakeCompound(const std::vector<ShapePtr>& shapes) {
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    
+    for (const auto& shape : shapes) {
+        if (shape && !shape->GetOCCTShape().IsNull()) {
+            builder.Add(compound, shape->GetOCCTShape());
+        }
+    }
+    
+    return std::make_shared<Shape>(compound);
+}
+
+ShapePtr BooleanOperations::MakeEmptyResult() {
+    // 与BRepAlgoAPI_Common求得空交集时一致：一个空的复合体
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    
+    return std::make_shared<Shape>(compound);
+}
+
 bool BooleanOperations::ValidateInputs(const ShapePtr& shape1, const ShapePtr& shape2) {
     if (!shape1 || !shape2) {
         return false;
@@ -0,0 +1,88 @@
+#include "cad_core/MassPropertyService.h"
+#include <BRepGProp.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <Standard_Failure.hxx>
+#include <algorithm>
+
+namespace cad_core {
+
+MassPropertyService::Result MassPropertyService::Compute(const TopoDS_Shape& shape, const Options& options) {
+    Result result;
+    if (shape.IsNull()) {
+        return result;
+    }
+    
+    std::vector<TopoDS_Shape> volumeItems;
+    std::vector<TopoDS_Shape> surfaceItems;
+    CollectVolumeItems(shape, volumeItems);
+    CollectSurfaceItems(shape, surfaceItems);
+    
+    // 每个部分的结果按下标写入，互不干扰
+    const int volumeCount = static_cast<int>(volumeItems.size());
+    const int itemCount = volumeCount + static_cast<int>(surfaceItems.size());
+    std::vector<GProp_GProps> itemProps(itemCount);
+    std::vector<double> itemErrors(itemCount, 0.0);
+    std::vector<char> itemValid(itemCount, 0);
+    
+    OSD_Parallel::For(0, itemCount, [&](const Standard_Integer index) {
+        try {
+            const bool isVolume = index < volumeCount;
+            const TopoDS_Shape& item = isVolume ? volumeItems[index] : surfaceItems[index - volumeCount];
+            
+            if (options.tolerance > 0.0) {
+                itemErrors[index] = isVolume
+                    ? BRepGProp::VolumeProperties(item, itemProps[index], options.tolerance)
+                    : BRepGProp::SurfaceProperties(item, itemProps[index], options.tolerance);
+            } else if (isVolume) {
+                BRepGProp::VolumeProperties(item, itemProps[index]);
+            } else {
+                BRepGProp::SurfaceProperties(item, itemProps[index]);
+            }
+            itemValid[index] = 1;
+        } catch (const Standard_Failure& e) {
+            // 单个部分失败不影响其他部分
+        }
+    }, !options.runParallel);
+    
+    // 按收集顺序串行归约，与线程调度无关
+    for (int index = 0; index < itemCount; index++) {
+        if (!itemValid[index] || itemProps[index].Mass() == 0.0) {
+            continue;
+        }
+        
+        if (index < volumeCount) {
+            result.volumeProps.Add(itemProps[index]);
+            result.volumeError = std::max(result.volumeError, itemErrors[index]);
+        } else {
+            result.surfaceProps.Add(itemProps[index]);
+            result.areaError = std::max(result.areaError, itemErrors[index]);
+        }
+    }
+    
+    return result;
+}
+
+void MassPropertyService::CollectVolumeItems(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& items) {
+    // 体积积分依赖参考点，只有封闭的实体才能单独积分后再合并
+    for (TopExp_Explorer exp(shape, TopAbs_SOLID); exp.More(); exp.Next()) {
+        items.push_back(exp.Current());
+    }
+    
+    // 不属于任何实体的壳和面，与BRepGProp::VolumeProperties的行为保持一致
+    for (TopExp_Explorer exp(shape, TopAbs_SHELL, TopAbs_SOLID); exp.More(); exp.Next()) {
+        items.push_back(exp.Current());
+    }
+    for (TopExp_Explorer exp(shape, TopAbs_FACE, TopAbs_SHELL); exp.More(); exp.Next()) {
+        items.push_back(exp.Current());
+    }
+}
+
+void MassPropertyService::CollectSurfaceItems(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& items) {
+    // 面积积分与参考点无关，可以拆到单个面
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        items.push_back(exp.Current());
+    }
+}
+
+} // namespace cad_core
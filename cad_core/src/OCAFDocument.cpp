@@ -7,6 +7,9 @@
 #include <TDataStd_Integer.hxx>
 #include <TNaming_Builder.hxx>
 #include <TNaming_NamedShape.hxx>
+#include <TDF_AttributeDelta.hxx>
+#include <TDF_ListIteratorOfLabelList.hxx>
+#include <TDF_MapIteratorOfLabelMap.hxx>
 #include <BinDrivers.hxx>
 #include <BinXCAFDrivers.hxx>
 #include <XmlDrivers.hxx>
@@ -85,6 +88,10 @@ void OCAFDocument::InitializeDocument() {
     
     // Initialize XCAFDoc tools
     m_shapeTool = XCAFDoc_DocumentTool::ShapeTool(m_document->Main());
+    
+    // New or freshly opened document: index everything once
+    m_shapeRegistry.Clear();
+    RebuildShapeIndex();
 }
 
 bool OCAFDocument::OpenDocument(const std::string& filename) {
@@ -141,6 +148,11 @@ TDF_Label OCAFDocument::AddShape(const ShapePtr& shape, const std::string& name)
             SetName(shapeLabel, "Shape");
         }
         
+        IndexShape(shapeLabel, shape->GetOCCTShape());
+        
+        // Hand the caller's pointer back from GetShape so views keyed on it keep matching
+        RegisterShape(shapeLabel, shape);
+        
         return shapeLabel;
     } catch (const Standard_Failure& e) {
         return TDF_Label();
@@ -166,6 +178,8 @@ bool OCAFDocument::RemoveShape(const TDF_Label& label) {
         // Mark as deleted but keep TNaming for undo/redo
         TDataStd_Integer::Set(label, 0); // Mark as deleted
         
+        UnindexLabel(label);
+        
         return true;
     } catch (const Standard_Failure& e) {
         return false;
@@ -182,7 +196,16 @@ ShapePtr OCAFDocument::GetShape(const TDF_Label& label) const {
         if (label.FindAttribute(TNaming_NamedShape::GetID(), namedShape)) {
             TopoDS_Shape shape = namedShape->Get();
             if (!shape.IsNull()) {
-                return std::make_shared<Shape>(shape);
+                // Reuse the registered wrapper while the label still holds the same shape
+                const RegisteredShape* registered = m_shapeRegistry.Seek(label);
+                if (registered && registered->version == namedShape->Version() &&
+                    registered->shape->GetOCCTShape().IsEqual(shape)) {
+                    return registered->shape;
+                }
+                
+                ShapePtr wrapper = std::make_shared<Shape>(shape);
+                RegisterShape(label, wrapper);
+                return wrapper;
             }
         }
         return nullptr;
@@ -191,6 +214,23 @@ ShapePtr OCAFDocument::GetShape(const TDF_Label& label) const {
     }
 }
 
+TDF_Label OCAFDocument::FindLabel(const ShapePtr& shape) const {
+    if (!shape) {
+        return TDF_Label();
+    }
+    
+    return FindLabel(shape->GetOCCTShape());
+}
+
+TDF_Label OCAFDocument::FindLabel(const TopoDS_Shape& shape) const {
+    if (shape.IsNull()) {
+        return TDF_Label();
+    }
+    
+    const TDF_Label* label = m_shapeIndex.Seek(shape);
+    return label ? *label : TDF_Label();
+}
+
 std::vector<TDF_Label> OCAFDocument::GetAllShapes() const {
     std::vector<TDF_Label> shapes;
     
@@ -337,7 +377,13 @@ bool OCAFDocument::Undo() {
     }
     
     try {
+        m_lastChanges = ShapeChanges();
         m_document->Undo();
+        
+        // The undone transaction now sits at the front of the redo list
+        if (!m_document->GetRedos().IsEmpty()) {
+            ReindexDelta(m_document->GetRedos().First());
+        }
         return true;
     } catch (const Standard_Failure& e) {
         return false;
@@ -350,7 +396,13 @@ bool OCAFDocument::Redo() {
     }
     
     try {
+        m_lastChanges = ShapeChanges();
         m_document->Redo();
+        
+        // The redone transaction is appended back to the undo list
+        if (!m_document->GetUndos().IsEmpty()) {
+            ReindexDelta(m_document->GetUndos().Last());
+        }
         return true;
     } catch (const Standard_Failure& e) {
         return false;
@@ -381,6 +433,7 @@ void OCAFDocument::StartTransaction(const std::string& name) {
     try {
         m_document->NewCommand();
         m_inTransaction = true;
+        m_transactionLabels.Clear();
         std::cout << "[OCAF] Transaction started: " << name << std::endl;
     } catch (const Standard_Failure& e) {
         m_inTransaction = false;
@@ -397,6 +450,7 @@ void OCAFDocument::CommitTransaction() {
     try {
         m_document->CommitCommand();
         m_inTransaction = false;
+        m_transactionLabels.Clear();
         std::cout << "[OCAF] Transaction committed. Available undos: " << m_document->GetAvailableUndos() << std::endl;
     } catch (const Standard_Failure& e) {
         m_inTransaction = false;
@@ -415,6 +469,12 @@ void OCAFDocument::AbortTransaction() {
     } catch (const Standard_Failure& e) {
         m_inTransaction = false;
     }
+    
+    // Roll the index back for every label this transaction touched
+    for (TDF_MapIteratorOfLabelMap it(m_transactionLabels); it.More(); it.Next()) {
+        ReindexLabel(it.Key());
+    }
+    m_transactionLabels.Clear();
 }
 
 TDF_Label OCAFDocument::GetRootLabel() const {
@@ -433,4 +493,102 @@ TDF_Label OCAFDocument::GetNextAvailableLabel(const TDF_Label& parent) {
     return parent.FindChild(tag, Standard_True);
 }
 
+void OCAFDocument::RegisterShape(const TDF_Label& label, const ShapePtr& shape) const {
+    Handle(TNaming_NamedShape) namedShape;
+    if (!shape || !label.FindAttribute(TNaming_NamedShape::GetID(), namedShape)) {
+        return;
+    }
+    
+    RegisteredShape registered;
+    registered.shape = shape;
+    registered.version = namedShape->Version();
+    m_shapeRegistry.Bind(label, registered);
+}
+
+void OCAFDocument::RebuildShapeIndex() {
+    m_shapeIndex.Clear();
+    m_labelIndex.Clear();
+    m_transactionLabels.Clear();
+    
+    for (const auto& label : GetAllShapes()) {
+        ReindexLabel(label);
+    }
+}
+
+void OCAFDocument::ReindexLabel(const TDF_Label& label) {
+    UnindexLabel(label);
+    
+    // Only live shapes are indexed: deleted ones keep a NamedShape with a null result
+    Handle(TNaming_NamedShape) namedShape;
+    if (label.FindAttribute(TNaming_NamedShape::GetID(), namedShape)) {
+        TopoDS_Shape shape = namedShape->Get();
+        if (!shape.IsNull()) {
+            IndexShape(label, shape);
+        }
+    }
+}
+
+void OCAFDocument::ReindexDelta(const Handle(TDF_Delta)& delta) {
+    if (delta.IsNull()) {
+        return;
+    }
+    
+    TDF_LabelList labels;
+    delta->Labels(labels);
+    for (TDF_ListIteratorOfLabelList it(labels); it.More(); it.Next()) {
+        const TDF_Label& label = it.Value();
+        if (label.Father() != m_shapesLabel) {
+            continue;
+        }
+        
+        // The pointer the UI knows for this label is the registered one, if it still matches
+        ShapePtr oldShape;
+        const TopoDS_Shape* indexed = m_labelIndex.Seek(label);
+        if (indexed) {
+            const RegisteredShape* registered = m_shapeRegistry.Seek(label);
+            oldShape = (registered && registered->shape->GetOCCTShape().IsEqual(*indexed))
+                ? registered->shape : std::make_shared<Shape>(*indexed);
+        }
+        
+        ReindexLabel(label);
+        ShapePtr newShape = m_labelIndex.IsBound(label) ? GetShape(label) : nullptr;
+        
+        if (!oldShape && newShape) {
+            m_lastChanges.added.push_back(newShape);
+        } else if (oldShape && !newShape) {
+            m_lastChanges.removed.push_back(oldShape);
+        } else if (oldShape && newShape && oldShape != newShape) {
+            m_lastChanges.modified.emplace_back(oldShape, newShape);
+        }
+    }
+}
+
+void OCAFDocument::IndexShape(const TDF_Label& label, const TopoDS_Shape& shape) {
+    UnindexLabel(label);
+    
+    m_shapeIndex.Bind(shape, label);
+    m_labelIndex.Bind(label, shape);
+    if (m_inTransaction) {
+        m_transactionLabels.Add(label);
+    }
+}
+
+void OCAFDocument::UnindexLabel(const TDF_Label& label) {
+    if (m_inTransaction) {
+        m_transactionLabels.Add(label);
+    }
+    
+    const TopoDS_Shape* indexed = m_labelIndex.Seek(label);
+    if (!indexed) {
+        return;
+    }
+    
+    // Another label may have re-bound the same shape in the meantime
+    const TDF_Label* owner = m_shapeIndex.Seek(*indexed);
+    if (owner && *owner == label) {
+        m_shapeIndex.UnBind(*indexed);
+    }
+    m_labelIndex.UnBind(label);
+}
+
 } // namespace cad_core
\ No newline at end of file
@@ -85,16 +85,13 @@ bool OCAFManager::RemoveShape(const ShapePtr& shape) {
         return false;
     }
     
-    // 查找对应此形状的标签
-    std::vector<TDF_Label> labels = m_document->GetAllShapes();
-    for (const auto& label : labels) {
-        ShapePtr labelShape = m_document->GetShape(label);
-        if (labelShape && labelShape->GetOCCTShape().IsSame(shape->GetOCCTShape())) {
-            return m_document->RemoveShape(label);
-        }
+    // 通过索引直接找到标签，不再遍历整个文档
+    TDF_Label label = m_document->FindLabel(shape);
+    if (label.IsNull()) {
+        return false; // 未找到形状
     }
     
-    return false; // 未找到形状
+    return m_document->RemoveShape(label);
 }
 
 bool OCAFManager::ReplaceShape(const ShapePtr& oldShape, const ShapePtr& newShape) {
@@ -103,24 +100,21 @@ bool OCAFManager::ReplaceShape(const ShapePtr& oldShape, const ShapePtr& newShap
     }
     
     // 查找对应旧形状的标签
-    std::vector<TDF_Label> labels = m_document->GetAllShapes();
-    for (const auto& label : labels) {
-        ShapePtr labelShape = m_document->GetShape(label);
-        if (labelShape && labelShape->GetOCCTShape().IsSame(oldShape->GetOCCTShape())) {
-            // 获取原有的名称
-            std::string name = m_document->GetName(label);
-            
-            // 移除旧形状
-            if (m_document->RemoveShape(label)) {
-                // 添加新形状，使用相同的名称
-                TDF_Label newLabel = m_document->AddShape(newShape, name);
-                return !newLabel.IsNull();
-            }
-            return false;
-        }
+    TDF_Label label = m_document->FindLabel(oldShape);
+    if (label.IsNull()) {
+        return false; // 未找到旧形状
     }
     
-    return false; // 未找到旧形状
+    // 获取原有的名称
+    std::string name = m_document->GetName(label);
+    
+    // 移除旧形状
+    if (m_document->RemoveShape(label)) {
+        // 添加新形状，使用相同的名称
+        TDF_Label newLabel = m_document->AddShape(newShape, name);
+        return !newLabel.IsNull();
+    }
+    return false;
 }
 
 ShapePtr OCAFManager::GetShape(const std::string& name) const {
@@ -204,6 +198,14 @@ bool OCAFManager::CanRedo() const {
     return m_document->CanRedo();
 }
 
+ShapeChanges OCAFManager::GetLastChanges() const {
+    if (!m_document) {
+        return ShapeChanges();
+    }
+    
+    return m_document->GetLastChanges();
+}
+
 void OCAFManager::StartTransaction(const std::string& name) {
     if (!m_document) {
         return;
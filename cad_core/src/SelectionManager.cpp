@@ -9,7 +9,7 @@
 
 namespace cad_core {
 
-SelectionManager::SelectionManager() : m_currentMode(SelectionMode::Shape) {
+SelectionManager::SelectionManager() : m_currentMode(SelectionMode::Shape), m_lazySubShapeActivation(false) {
 }
 
 SelectionManager::~SelectionManager() {
@@ -44,19 +44,22 @@ void SelectionManager::UpdateSelectionMode() {
     m_context->Deactivate();
     
     // 激活对应的选择模式
-    switch (m_currentMode) {
-        case SelectionMode::Shape:
-            m_context->Activate(0); // 形状模式
-            break;
-        case SelectionMode::Face:
-            m_context->Activate(4); // 面模式
-            break;
-        case SelectionMode::Edge:
-            m_context->Activate(2); // 边模式
-            break;
-        case SelectionMode::Vertex:
-            m_context->Activate(1); // 顶点模式
-            break;
+    // 延迟模式下面/边/顶点模式不做全局激活，由视图对光标下的对象按需激活
+    if (!m_lazySubShapeActivation || m_currentMode == SelectionMode::Shape) {
+        switch (m_currentMode) {
+            case SelectionMode::Shape:
+                m_context->Activate(0); // 形状模式
+                break;
+            case SelectionMode::Face:
+                m_context->Activate(4); // 面模式
+                break;
+            case SelectionMode::Edge:
+                m_context->Activate(2); // 边模式
+                break;
+            case SelectionMode::Vertex:
+                m_context->Activate(1); // 顶点模式
+                break;
+        }
     }
     
     // 设置高亮颜色
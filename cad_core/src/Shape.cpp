@@ -7,17 +7,105 @@
  */
 
 #include "cad_core/Shape.h"
-#include <GProp_GProps.hxx>  // 几何属性计算 - OpenCASCADE的瑞士军刀
-#include <BRepGProp.hxx>     // 边界表示几何属性 - 专门处理实体几何
+#include "cad_core/MassPropertyService.h"
+#include <BRepBndLib.hxx>    // 包围盒计算
+#include <Standard_Failure.hxx>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 
 namespace cad_core {
 
+namespace {
+
+/**
+ * 属性计算的共享工作线程池
+ * 线程数固定（每个形状内部的积分还会用到OCCT线程池），程序退出时丢弃排队的任务并等待线程结束
+ */
+class PropertyWorkerPool {
+public:
+    static PropertyWorkerPool& Instance() {
+        static PropertyWorkerPool pool;
+        return pool;
+    }
+    
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_condition.notify_one();
+    }
+    
+    ~PropertyWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_tasks.clear();  // 未开始的任务的promise随之析构，等待方得到broken_promise
+        }
+        m_condition.notify_all();
+        
+        for (auto& worker : m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+private:
+    PropertyWorkerPool() : m_stopping(false) {
+        unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency() / 4);
+        for (unsigned int i = 0; i < threadCount; i++) {
+            m_workers.emplace_back(&PropertyWorkerPool::WorkerLoop, this);
+        }
+    }
+    
+    void WorkerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+    
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+};
+
+} // anonymous namespace
+
+/**
+ * 属性缓存的内部状态
+ * 后台线程只持有它的weak_ptr，形状销毁后算出来的结果直接丢掉
+ */
+struct Shape::PropertyCache {
+    std::mutex mutex;
+    PropertiesPtr properties;
+    PropertiesPtr estimate;
+    std::shared_future<PropertiesPtr> pending;
+};
+
 /**
  * 默认构造函数 - 创建一个空形状
  * 就像准备一个空盒子，等待装入美妙的几何体
  */
-Shape::Shape() {
+Shape::Shape() : m_propertyCache(std::make_shared<PropertyCache>()) {
     // 什么都不做，就是这么简单！
     // OpenCASCADE的TopoDS_Shape默认就是null状态
 }
@@ -27,7 +115,8 @@ Shape::Shape() {
  * 这是我们最常用的构造方式，把原生形状"包装"起来
  * @param shape 要包装的OpenCASCADE形状
  */
-Shape::Shape(const TopoDS_Shape& shape) : m_shape(shape) {
+Shape::Shape(const TopoDS_Shape& shape)
+    : m_shape(shape), m_propertyCache(std::make_shared<PropertyCache>()) {
     // 直接拷贝构造，简单粗暴但有效
     // TODO: 可能需要添加形状有效性检查
 }
@@ -48,6 +137,11 @@ const TopoDS_Shape& Shape::GetOCCTShape() const {
  */
 void Shape::SetOCCTShape(const TopoDS_Shape& shape) {
     m_shape = shape;
+    
+    // 形状换了，缓存的包围盒和属性也就作废了
+    m_hasBoundingBox = false;
+    m_hasOrientedBoundingBox = false;
+    m_propertyCache = std::make_shared<PropertyCache>();
     // TODO: 考虑添加变更通知机制，让依赖的对象知道形状变了
 }
 
@@ -62,8 +156,8 @@ bool Shape::IsValid() const {
 
 /**
  * 计算体积
- * 使用OpenCASCADE的几何属性计算功能
- * 注意：这里的"Mass"实际上是体积，OpenCASCADE的命名有时候很迷惑
+ * 以前每次调用都重跑BRepGProp，大模型选中一次要卡好几秒
+ * 现在走属性缓存，只有第一次才真正计算
  * @return 体积值，如果形状无效则返回0
  */
 double Shape::Volume() const {
@@ -72,17 +166,7 @@ double Shape::Volume() const {
         return 0.0;
     }
     
-    // OpenCASCADE的几何属性计算器
-    GProp_GProps props;
-    
-    // 计算体积属性，BRepGProp就是专门干这个的
-    BRepGProp::VolumeProperties(m_shape, props);
-    
-    // Mass()实际返回的是体积，别被名字骗了
-    return props.Mass();
-    
-    // TODO: 添加异常处理，有些奇怪的形状可能会让计算崩溃
-    // TODO: 考虑缓存体积计算结果，避免重复计算
+    return GetProperties()->volume;
 }
 
 /**
@@ -96,17 +180,172 @@ double Shape::Area() const {
         return 0.0;
     }
     
-    // 又是熟悉的几何属性计算器
-    GProp_GProps props;
+    return GetProperties()->area;
     
-    // 计算表面积属性
-    BRepGProp::SurfaceProperties(m_shape, props);
+    // TODO: 对于线框模型，这个函数的行为可能不符合预期
+}
+
+/**
+ * 获取全部几何属性
+ * 有后台任务就等它，没有就当场算；计算本身不持锁
+ * @return 属性快照
+ */
+Shape::PropertiesPtr Shape::GetProperties() const {
+    std::shared_ptr<PropertyCache> cache = m_propertyCache;
+    std::shared_future<PropertiesPtr> pending;
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        if (cache->properties) {
+            return cache->properties;
+        }
+        pending = cache->pending;
+    }
+    
+    if (pending.valid()) {
+        try {
+            return pending.get();
+        } catch (...) {
+            // 后台计算失败，下面当场再算一次
+        }
+    }
     
-    // 这里的Mass()返回的才是真正的表面积
-    return props.Mass();
+    PropertiesPtr properties = std::make_shared<const ShapeProperties>(
+        ShapeProperties::Compute(m_shape, MassPropertyService::PRECISE_TOLERANCE));
     
-    // TODO: 对于线框模型，这个函数的行为可能不符合预期
-    // TODO: 考虑添加不同类型形状的特殊处理
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (!cache->properties) {
+        cache->properties = properties;
+    }
+    return cache->properties;
+}
+
+/**
+ * 只读缓存
+ * @return 已缓存的属性或nullptr
+ */
+Shape::PropertiesPtr Shape::GetCachedProperties() const {
+    std::lock_guard<std::mutex> lock(m_propertyCache->mutex);
+    return m_propertyCache->properties;
+}
+
+/**
+ * 获取快速估算值
+ * @return 估算值或nullptr
+ */
+Shape::PropertiesPtr Shape::GetEstimatedProperties() const {
+    std::lock_guard<std::mutex> lock(m_propertyCache->mutex);
+    return m_propertyCache->estimate;
+}
+
+/**
+ * 后台计算属性
+ * 交给共享的工作线程池，而不是std::async，免得future析构时把UI线程卡住
+ * @return 共享的future，计算出错时携带异常
+ */
+std::shared_future<Shape::PropertiesPtr> Shape::ComputePropertiesAsync() const {
+    std::shared_ptr<PropertyCache> cache = m_propertyCache;
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    
+    if (cache->properties) {
+        std::promise<PropertiesPtr> ready;
+        ready.set_value(cache->properties);
+        return ready.get_future().share();
+    }
+    
+    if (cache->pending.valid()) {
+        return cache->pending;
+    }
+    
+    auto promise = std::make_shared<std::promise<PropertiesPtr>>();
+    cache->pending = promise->get_future().share();
+    
+    std::weak_ptr<PropertyCache> weakCache = cache;
+    TopoDS_Shape shape = m_shape;
+    PropertyWorkerPool::Instance().Submit([weakCache, promise, shape]() {
+        try {
+            // 第一遍：低精度自适应积分，几十毫秒就能给UI一个大概的数
+            ShapeProperties estimate = ShapeProperties::Compute(shape, MassPropertyService::ESTIMATE_TOLERANCE);
+            estimate.isEstimate = true;
+            if (std::shared_ptr<PropertyCache> owner = weakCache.lock()) {
+                std::lock_guard<std::mutex> lock(owner->mutex);
+                owner->estimate = std::make_shared<const ShapeProperties>(estimate);
+            }
+            
+            // 第二遍：高精度只重算积分，包围盒和拓扑计数沿用第一遍的结果，写入正式缓存
+            PropertiesPtr properties = std::make_shared<const ShapeProperties>(
+                estimate.Refine(shape, MassPropertyService::PRECISE_TOLERANCE));
+            
+            if (std::shared_ptr<PropertyCache> owner = weakCache.lock()) {
+                std::lock_guard<std::mutex> lock(owner->mutex);
+                if (!owner->properties) {
+                    owner->properties = properties;
+                }
+            }
+            promise->set_value(properties);
+        } catch (...) {
+            // 任何异常都交给等待方，不能让工作线程终止进程，也不能让future永远不就绪
+            promise->set_exception(std::current_exception());
+        }
+    });
+    
+    return cache->pending;
+}
+
+/**
+ * 获取轴对齐包围盒
+ * BRepBndLib::Add会把形状公差也算进去，所以贴合的形状不会被误判为分离
+ * @return 缓存的包围盒，空形状返回空盒（Void）
+ */
+const Bnd_Box& Shape::GetBoundingBox() const {
+    if (!m_hasBoundingBox) {
+        m_boundingBox.SetVoid();
+        if (IsValid()) {
+            BRepBndLib::Add(m_shape, m_boundingBox);
+        }
+        m_hasBoundingBox = true;
+    }
+    return m_boundingBox;
+}
+
+/**
+ * 获取有向包围盒
+ * 对斜放的长条形状特别有用，轴对齐包围盒会大出很多
+ * @return 缓存的有向包围盒
+ */
+const Bnd_OBB& Shape::GetOrientedBoundingBox() const {
+    if (!m_hasOrientedBoundingBox) {
+        m_orientedBoundingBox = Bnd_OBB();
+        if (IsValid()) {
+            BRepBndLib::AddOBB(m_shape, m_orientedBoundingBox);
+        }
+        m_hasOrientedBoundingBox = true;
+    }
+    return m_orientedBoundingBox;
+}
+
+/**
+ * 判断包围盒是否相交
+ * 先比轴对齐包围盒，便宜；需要时再比有向包围盒，更准
+ * @param other 另一个形状
+ * @param useOriented 是否启用有向包围盒复查
+ * @return false表示一定分离
+ */
+bool Shape::BoundingBoxOverlaps(const Shape& other, bool useOriented) const {
+    const Bnd_Box& box = GetBoundingBox();
+    const Bnd_Box& otherBox = other.GetBoundingBox();
+    if (box.IsVoid() || otherBox.IsVoid() || box.IsOut(otherBox)) {
+        return false;
+    }
+    
+    if (useOriented) {
+        const Bnd_OBB& obb = GetOrientedBoundingBox();
+        const Bnd_OBB& otherObb = other.GetOrientedBoundingBox();
+        if (!obb.IsVoid() && !otherObb.IsVoid() && obb.IsOut(otherObb)) {
+            return false;
+        }
+    }
+    
+    return true;
 }
 
 } // namespace cad_core
@@ -0,0 +1,84 @@
+﻿#include "cad_core/ShapeProperties.h"
+#include "cad_core/MassPropertyService.h"
+#include <BRepBndLib.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <Precision.hxx>
+#include <Standard_Failure.hxx>
+#include <cmath>
+
+namespace cad_core {
+
+namespace {
+
+int CountSubShapes(const TopoDS_Shape& shape, TopAbs_ShapeEnum type) {
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(shape, type, map);
+    return map.Extent();
+}
+
+// 只填体积、面积、重心和惯性矩这些依赖积分精度的字段
+void ComputeMassFields(const TopoDS_Shape& shape, double tolerance, ShapeProperties& props) {
+    MassPropertyService::Options options;
+    options.tolerance = tolerance;
+    MassPropertyService::Result massResult = MassPropertyService::Compute(shape, options);
+    
+    const GProp_GProps& volumeProps = massResult.volumeProps;
+    const GProp_GProps& surfaceProps = massResult.surfaceProps;
+    props.volume = volumeProps.Mass();
+    props.area = surfaceProps.Mass();
+    
+    // 没有体积的形状（面、壳）用面积属性的重心和惯性矩
+    const GProp_GProps& massProps =
+        std::abs(props.volume) > Precision::Confusion() ? volumeProps : surfaceProps;
+    if (std::abs(massProps.Mass()) > Precision::Confusion()) {
+        props.centroid = massProps.CentreOfMass();
+        props.inertia = massProps.MatrixOfInertia();
+    }
+}
+
+} // namespace
+
+ShapeProperties ShapeProperties::Compute(const TopoDS_Shape& shape, double tolerance) {
+    ShapeProperties props;
+    if (shape.IsNull()) {
+        return props;
+    }
+    
+    try {
+        ComputeMassFields(shape, tolerance, props);
+        
+        // 只用几何不读网格：属性在工作线程上计算，界面线程可能同时给这些面挂上新网格
+        BRepBndLib::Add(shape, props.boundingBox, Standard_False);
+        
+        props.solidCount = CountSubShapes(shape, TopAbs_SOLID);
+        props.shellCount = CountSubShapes(shape, TopAbs_SHELL);
+        props.faceCount = CountSubShapes(shape, TopAbs_FACE);
+        props.edgeCount = CountSubShapes(shape, TopAbs_EDGE);
+        props.vertexCount = CountSubShapes(shape, TopAbs_VERTEX);
+    } catch (const Standard_Failure& e) {
+        // 计算失败，保留已经得到的部分结果
+    }
+    
+    return props;
+}
+
+ShapeProperties ShapeProperties::Refine(const TopoDS_Shape& shape, double tolerance) const {
+    ShapeProperties props = *this;
+    props.isEstimate = false;
+    props.centroid = gp_Pnt();
+    props.inertia = gp_Mat();
+    if (shape.IsNull()) {
+        return props;
+    }
+    
+    try {
+        ComputeMassFields(shape, tolerance, props);
+    } catch (const Standard_Failure& e) {
+        // 计算失败，保留已经得到的部分结果
+    }
+    
+    return props;
+}
+
+} // namespace cad_core
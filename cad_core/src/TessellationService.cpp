@@ -0,0 +1,104 @@
+#include "cad_core/TessellationService.h"
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <Standard_Failure.hxx>
+#include <algorithm>
+
+namespace cad_core {
+
+TessellationService::TessellationService(unsigned int threadCount) : m_stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    
+    for (unsigned int i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&TessellationService::WorkerLoop, this);
+    }
+}
+
+TessellationService::~TessellationService() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_tasks.clear();
+    }
+    m_condition.notify_all();
+    
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void TessellationService::Submit(const ShapePtr& shape, double linearDeflection, double angularDeflection, Callback callback) {
+    if (!shape || !shape->IsValid()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back({shape, linearDeflection, angularDeflection, std::move(callback)});
+    }
+    m_condition.notify_one();
+}
+
+void TessellationService::Cancel(const ShapePtr& shape) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(),
+                                 [&shape](const Task& task) { return task.shape == shape; }),
+                  m_tasks.end());
+}
+
+void TessellationService::CancelAll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.clear();
+}
+
+size_t TessellationService::PendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+bool TessellationService::Tessellate(const TopoDS_Shape& shape, double linearDeflection, double angularDeflection) {
+    if (shape.IsNull()) {
+        return false;
+    }
+    
+    try {
+        IMeshTools_Parameters parameters;
+        parameters.Deflection = linearDeflection;
+        parameters.Angle = angularDeflection;
+        parameters.Relative = Standard_False;
+        parameters.InParallel = Standard_True;  // 同一形状的各个面并行划分
+        
+        BRepMesh_IncrementalMesh mesher(shape, parameters);
+        return mesher.IsDone();
+    } catch (const Standard_Failure& e) {
+        // 网格划分失败，交给显示时再试一次
+    }
+    
+    return false;
+}
+
+void TessellationService::WorkerLoop() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        
+        bool success = Tessellate(task.shape->GetOCCTShape(), task.linearDeflection, task.angularDeflection);
+        if (task.callback) {
+            task.callback(task.shape, success);
+        }
+    }
+}
+
+} // namespace cad_core
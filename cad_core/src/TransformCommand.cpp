@@ -1,5 +1,8 @@
 ﻿#include "cad_core/TransformCommand.h"
 #include <BRepBuilderAPI_Transform.hxx>
+#include <TopLoc_Location.hxx>
+#include <Standard_Failure.hxx>
+#include <Precision.hxx>
 #include <gp_Vec.hxx>
 #include <gp_Ax1.hxx>
 #include <gp_Pnt.hxx>
@@ -14,7 +17,11 @@ namespace cad_core {
 // =============================================================================
 
 TransformCommand::TransformCommand(const std::vector<ShapePtr>& shapes, TransformationType type)
-    : m_originalShapes(shapes), m_type(type), m_executed(false) {
+    : m_originalShapes(shapes), m_type(type), m_executed(false), m_copyCount(0) {
+}
+
+void TransformCommand::SetCopyCount(int count) {
+    m_copyCount = count > 0 ? count : 0;
 }
 
 bool TransformCommand::Execute() {
@@ -22,37 +29,90 @@ bool TransformCommand::Execute() {
         return true;
     }
 
+    try {
+        m_transformedShapes = ComputeTransformedShapes();
+        if (m_transformedShapes.empty()) {
+            return false;
+        }
+        
+        m_executed = true;
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+std::vector<ShapePtr> TransformCommand::ComputeTransformedShapes() const {
+    std::vector<ShapePtr> result;
+    
     try {
         // 创建变换矩阵
         gp_Trsf transformation = CreateTransformation();
         
-        // 对每个形状应用变换
-        m_transformedShapes.clear();
-        m_transformedShapes.reserve(m_originalShapes.size());
+        // 刚体变换（平移、旋转）只需叠加TopLoc_Location，不复制也不改写几何：
+        // 移动一个大实体是O(1)的，OCAF撤销历史里也只多一个变换矩阵。
+        // 缩放不能放进位置（OCCT的位置不允许带缩放），仍走几何变换
+        bool locationOnly = IsRigidTransformation() && IsLocationTransformation(transformation);
+        
+        // 复制模式下第k个副本应用k次变换（阵列）
+        std::vector<gp_Trsf> placements = GetPlacements();
+        result.reserve(m_originalShapes.size() * placements.size());
         
         for (const auto& shape : m_originalShapes) {
             if (!shape || !shape->IsValid()) {
                 continue;
             }
             
-            // 应用变换
-            BRepBuilderAPI_Transform transformer(shape->GetOCCTShape(), transformation);
-            
-            if (!transformer.IsDone()) {
-                return false;
+            for (const gp_Trsf& placement : placements) {
+                // 刚体变换的结果（以及刚体副本）只是同一几何的不同放置
+                if (locationOnly) {
+                    result.push_back(PlaceShape(shape, placement));
+                    continue;
+                }
+                
+                // 应用变换
+                BRepBuilderAPI_Transform transformer(shape->GetOCCTShape(), placement, IsCopyMode());
+                if (!transformer.IsDone()) {
+                    return std::vector<ShapePtr>();
+                }
+                
+                // 创建变换后的形状
+                result.push_back(std::make_shared<Shape>(transformer.Shape()));
             }
-            
-            // 创建变换后的形状
-            auto transformedShape = std::make_shared<Shape>(transformer.Shape());
-            m_transformedShapes.push_back(transformedShape);
         }
-        
-        m_executed = true;
-        return true;
     }
-    catch (const std::exception& e) {
-        return false;
+    catch (const Standard_Failure& e) {
+        return std::vector<ShapePtr>();
+    }
+    
+    return result;
+}
+
+std::vector<gp_Trsf> TransformCommand::GetPlacements() const {
+    gp_Trsf transformation = CreateTransformation();
+    int placementCount = IsCopyMode() ? m_copyCount : 1;
+    
+    std::vector<gp_Trsf> placements;
+    placements.reserve(placementCount);
+    
+    gp_Trsf placement;
+    for (int k = 1; k <= placementCount; ++k) {
+        placement = transformation * placement;
+        placements.push_back(placement);
     }
+    return placements;
+}
+
+bool TransformCommand::IsLocationTransformation(const gp_Trsf& transformation) {
+    return !transformation.IsNegative() &&
+           std::abs(transformation.ScaleFactor() - 1.0) <= Precision::Confusion();
+}
+
+ShapePtr TransformCommand::PlaceShape(const ShapePtr& shape, const gp_Trsf& placement) const {
+    // 只叠加位置：TShape（几何、拓扑、网格）与原形状共享
+    TopoDS_Shape instance = shape->GetOCCTShape().Moved(TopLoc_Location(placement));
+    return std::make_shared<Shape>(instance);
 }
 
 bool TransformCommand::Undo() {
@@ -79,30 +139,8 @@ const char* TransformCommand::GetName() const {
 
 std::vector<ShapePtr> TransformCommand::GetTransformedShapes() const {
     if (!m_executed) {
-        // 为预览创建临时变换形状
-        std::vector<ShapePtr> previewShapes;
-        previewShapes.reserve(m_originalShapes.size());
-        
-        try {
-            gp_Trsf transformation = CreateTransformation();
-            
-            for (const auto& shape : m_originalShapes) {
-                if (!shape || !shape->IsValid()) {
-                    continue;
-                }
-                
-                BRepBuilderAPI_Transform transformer(shape->GetOCCTShape(), transformation);
-                if (transformer.IsDone()) {
-                    auto previewShape = std::make_shared<Shape>(transformer.Shape());
-                    previewShapes.push_back(previewShape);
-                }
-            }
-        }
-        catch (const std::exception& e) {
-            // 返回空vector如果变换失败
-        }
-        
-        return previewShapes;
+        // 为预览创建临时变换形状，变换失败时返回空vector
+        return ComputeTransformedShapes();
     }
     
     return m_transformedShapes;
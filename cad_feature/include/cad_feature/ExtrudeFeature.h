@@ -32,8 +32,14 @@ public:
     
     // Feature interface
     cad_core::ShapePtr CreateShape() const override;
+    cad_core::ShapePtr CreatePreviewShape(const Message_ProgressRange& progress = Message_ProgressRange()) const override;
     bool ValidateParameters() const override;
+    std::vector<cad_sketch::SketchPtr> GetInputSketches() const override;
     std::shared_ptr<cad_core::ICommand> CreateCommand() const override;
+    FeaturePtr Clone() const override;
+
+protected:
+    void HashInputs(std::size_t& seed) const override;
 
 private:
     cad_sketch::SketchPtr m_sketch;
@@ -18,9 +18,12 @@
 
 #include "cad_core/Shape.h"    // 几何形状基础 - 特征的"原材料"
 #include "cad_core/ICommand.h" // 命令接口 - 让特征具备撤销/重做能力
+#include "cad_sketch/Sketch.h" // 草图 - 大多数特征的输入
+#include <Message_ProgressRange.hxx> // 进度与取消 - 让预览可以被中途叫停
 #include <memory>              // 智能指针 - 现代C++的内存管家
 #include <string>              // 字符串 - 特征名称和参数的载体
 #include <map>                 // 映射容器 - 参数名到参数值的字典
+#include <vector>              // 动态数组 - 输入草图列表
 
 namespace cad_feature {
 
@@ -158,6 +161,35 @@ public:
      */
     bool HasParameter(const std::string& name) const;
     
+    /** 
+     * 获取全部参数 - 结果缓存命中时逐项核对，防止哈希碰撞
+     * @return 参数名到参数值的映射
+     */
+    const std::map<std::string, double>& GetParameters() const;
+    
+    // ========== 依赖与修订 - 增量重建的依据 ==========
+    
+    /** 
+     * 获取输入草图 - 特征形状依赖的所有草图
+     * FeatureManager 据此把草图的修改传播到使用它的特征
+     * @return 输入草图列表，默认没有
+     */
+    virtual std::vector<cad_sketch::SketchPtr> GetInputSketches() const;
+    
+    /** 
+     * 获取修订号 - 参数或输入每变化一次就加一
+     * FeatureManager 对比上次重建时的修订号来判断特征是否需要重算
+     * @return 当前修订号
+     */
+    unsigned int GetRevision() const;
+    
+    /** 
+     * 计算输入哈希 - 特征类型、全部参数和输入几何的内容哈希
+     * CreateShape 是这些输入的纯函数，哈希相同即可复用之前的结果
+     * @return 64位内容哈希
+     */
+    std::size_t ComputeInputHash() const;
+    
     // ========== 形状操作 - 特征的"表演时刻" ==========
     
     /** 
@@ -169,10 +201,19 @@ public:
     
     /** 
      * 创建预览形状 - 让用户提前"试看"效果
-     * 默认和正式创建一样，但可以做得更快一些
+     * 默认和正式创建一样；派生类给出不做实体校验的低精度近似，
+     * 精确结果只在提交时由 CreateShape 计算。可能在工作线程上调用
+     * @param progress 进度范围，UserBreak() 为真时应尽快放弃并返回空
      * @return 预览用的几何形状
      */
-    virtual cad_core::ShapePtr CreatePreviewShape() const;
+    virtual cad_core::ShapePtr CreatePreviewShape(const Message_ProgressRange& progress = Message_ProgressRange()) const;
+    
+    /** 
+     * 复制特征 - 得到参数和输入草图几何的独立快照（ID相同）
+     * 后台预览在快照上计算，界面线程可以继续修改原特征和它的草图
+     * @return 特征副本
+     */
+    virtual std::shared_ptr<Feature> Clone() const = 0;
     
     /** 
      * 验证参数 - 检查参数设置是否合理
@@ -208,6 +249,36 @@ protected:
     /** 参数映射表 - 特征的"控制面板"，存储所有可调参数 */
     std::map<std::string, double> m_parameters;
     
+    /** 修订号 - 参数或输入变化的计数 */
+    unsigned int m_revision;
+    
+    /** 标记输入已变化 - 派生类设置草图、平面等非参数输入时调用 */
+    void Touch();
+    
+    /** 
+     * 哈希非参数输入 - 默认依次混入输入草图的几何哈希
+     * 派生类还有平面等其他输入时重写并先调用基类版本
+     * @param seed 累积中的哈希值
+     */
+    virtual void HashInputs(std::size_t& seed) const;
+    
+    /** 草图快照 - 供 Clone 使用，空指针原样返回 */
+    static cad_sketch::SketchPtr SnapshotSketch(const cad_sketch::SketchPtr& sketch);
+    
+    /** 哈希混合工具 - 供 HashInputs 使用 */
+    static void HashCombine(std::size_t& seed, std::size_t value);
+    static void HashValue(std::size_t& seed, double value);
+    static void HashPlane(std::size_t& seed, const gp_Pln& plane);
+    
+    /** 
+     * 草图轮廓 - 把草图元素逐个变成平面上的三维边，放进一个复合体
+     * 预览专用：不拼接线框、不成面，草图没闭合或不连续也能出结果
+     * @param sketch 草图
+     * @param plane 草图所在平面
+     * @return 边的复合体，草图为空时返回空形状
+     */
+    static TopoDS_Shape BuildSketchOutline(const cad_sketch::SketchPtr& sketch, const gp_Pln& plane);
+    
     /** 静态ID计数器 - 用来分配唯一ID的"号码机" */
     static int s_nextId;
 };
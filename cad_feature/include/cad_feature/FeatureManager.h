@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Feature.h"
+#include "FeatureResultCache.h"
+#include <functional>
+#include <map>
+#include <set>
 #include <vector>
 #include <memory>
 #include <string>
@@ -33,6 +37,31 @@ public:
     void MoveFeatureDown(const FeaturePtr& feature);
     void MoveFeatureToIndex(const FeaturePtr& feature, int index);
     
+    // 依赖关系：downstream 使用 upstream 的结果（草图依赖由 Feature::GetInputSketches 隐式给出）
+    // 会形成环的依赖被拒绝
+    bool AddDependency(const FeaturePtr& downstream, const FeaturePtr& upstream);
+    void RemoveDependency(const FeaturePtr& downstream, const FeaturePtr& upstream);
+    std::vector<FeaturePtr> GetUpstreamFeatures(const FeaturePtr& feature) const;
+    std::vector<FeaturePtr> GetDownstreamFeatures(const FeaturePtr& feature) const;
+    
+    // 脏标记：标记特征本身及其下游整个锥体；修订号变化的特征在重建时自动视为脏
+    void MarkFeatureDirty(const FeaturePtr& feature);
+    void MarkSketchDirty(const cad_sketch::SketchPtr& sketch);
+    bool IsFeatureDirty(const FeaturePtr& feature) const;
+    
+    // 按拓扑顺序只重算脏特征；互不依赖的特征在同一波次内并行构造
+    bool RebuildDirtyFeatures();
+    
+    void SetRunParallel(bool runParallel);
+    bool GetRunParallel() const;
+    
+    // 最近一次成功执行的结果
+    cad_core::ShapePtr GetFeatureResult(const FeaturePtr& feature) const;
+    
+    // 结果缓存：输入未变的特征直接复用结果，可与 LivePreview 共用同一个缓存
+    void SetResultCache(const FeatureResultCachePtr& cache);
+    const FeatureResultCachePtr& GetResultCache() const;
+    
     // 更新和重建
     void UpdateFeature(const FeaturePtr& feature);
     void RebuildAllFeatures();
@@ -49,12 +78,37 @@ public:
 private:
     std::vector<FeaturePtr> m_features;
     
+    // 每个特征的重建记录，按特征ID索引
+    struct FeatureRecord {
+        cad_core::ShapePtr result;
+        FeatureResultCache::Key key;  // 结果缓存的键，下游的键包含它的哈希
+        unsigned int builtRevision = 0;
+        bool built = false;
+        bool dirty = true;
+    };
+    std::map<int, FeatureRecord> m_records;
+    
+    // 特征之间的显式依赖边（按特征ID）
+    std::map<int, std::set<int>> m_upstream;
+    std::map<int, std::set<int>> m_downstream;
+    
+    bool m_runParallel;
+    FeatureResultCachePtr m_resultCache;
+    
     // 回调函数
     std::function<void(const FeaturePtr&)> m_featureAddedCallback;
     std::function<void(const FeaturePtr&)> m_featureRemovedCallback;
     std::function<void(const FeaturePtr&)> m_featureUpdatedCallback;
     
     int FindFeatureIndex(const FeaturePtr& feature) const;
+    bool NeedsRebuild(const FeaturePtr& feature) const;
+    bool DependsOn(int featureId, int upstreamId) const;
+    void PropagateDirty(const std::set<int>& seeds);
+    std::vector<FeaturePtr> SortTopologically(const std::set<int>& featureIds) const;
+    std::vector<std::vector<FeaturePtr>> GroupIntoWaves(const std::vector<FeaturePtr>& order) const;
+    bool RunFeature(const FeaturePtr& feature);
+    bool BeginRun(const FeaturePtr& feature);
+    bool FinishRun(const FeaturePtr& feature, const cad_core::ShapePtr& shape);
     void NotifyFeatureAdded(const FeaturePtr& feature);
     void NotifyFeatureRemoved(const FeaturePtr& feature);
     void NotifyFeatureUpdated(const FeaturePtr& feature);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Feature.h"
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cad_feature {
+
+/**
+ * @class FeatureResultCache
+ * @brief 特征结果缓存 - 以输入内容哈希为键，按LRU在内存预算内保留形状
+ * 
+ * 键由特征类型、参数、输入草图几何、上游结果的键以及是否预览共同决定，
+ * 参数来回切换、撤销参数修改、预览后按相同参数提交都直接命中。
+ * 缓存的形状会被多处共享，取出后不要修改；加入文档前要复制拓扑（文档按 IsSame 索引形状）。只在GUI线程访问。
+ */
+class FeatureResultCache {
+public:
+    /**
+     * @struct Key
+     * @brief 缓存键 - hash 只用于索引，命中时其余字段逐项核对，
+     * 哈希碰撞不会取到别的特征的结果
+     */
+    struct Key {
+        std::size_t hash = 0;
+        bool preview = false;
+        FeatureType type = FeatureType::Extrude;
+        std::map<std::string, double> parameters;
+        std::size_t inputHash = 0;                // 特征的输入哈希（含草图几何）
+        std::vector<std::size_t> upstreamHashes;  // 上游结果键的哈希
+        
+        bool operator==(const Key& other) const;
+        bool operator!=(const Key& other) const { return !(*this == other); }
+    };
+
+    explicit FeatureResultCache(std::size_t memoryBudget = 256 * 1024 * 1024);
+    ~FeatureResultCache() = default;
+
+    /** 
+     * 组合缓存键
+     * @param feature 特征
+     * @param preview 预览形状和正式形状分开缓存
+     * @param upstreamHashes 上游特征结果键的哈希，按固定顺序给出
+     */
+    static Key MakeKey(const Feature& feature, bool preview,
+                       const std::vector<std::size_t>& upstreamHashes = {});
+    
+    /** 查找结果，命中时移到最近使用端；未命中（含哈希相同但键不同）返回nullptr */
+    cad_core::ShapePtr Find(const Key& key);
+    
+    /** 插入结果，超出预算时淘汰最久未用的条目；哈希相同的旧条目被替换 */
+    void Insert(const Key& key, const cad_core::ShapePtr& shape);
+    
+    void Remove(const Key& key);
+    void Clear();
+    
+    void SetMemoryBudget(std::size_t bytes);
+    std::size_t GetMemoryBudget() const;
+    std::size_t GetMemoryUsage() const;
+    
+    int GetEntryCount() const;
+    int GetHitCount() const;
+    int GetMissCount() const;
+
+private:
+    struct Entry {
+        Key key;
+        cad_core::ShapePtr shape;
+        std::size_t bytes;
+    };
+    
+    // 链表头部是最近使用的条目
+    std::list<Entry> m_entries;
+    std::unordered_map<std::size_t, std::list<Entry>::iterator> m_index;
+    
+    std::size_t m_memoryBudget;
+    std::size_t m_memoryUsage;
+    int m_hitCount;
+    int m_missCount;
+    
+    void EvictToBudget();
+    static std::size_t EstimateMemory(const cad_core::ShapePtr& shape);
+};
+
+using FeatureResultCachePtr = std::shared_ptr<FeatureResultCache>;
+
+} // namespace cad_feature
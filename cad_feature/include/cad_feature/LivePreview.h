@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Feature.h"
+#include "FeatureResultCache.h"
 #include <QObject>
 #include <QTimer>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 namespace cad_feature {
 
@@ -12,7 +17,7 @@ class LivePreview : public QObject {
 
 public:
     explicit LivePreview(QObject* parent = nullptr);
-    ~LivePreview() = default;
+    ~LivePreview();
 
     void SetFeature(const FeaturePtr& feature);
     const FeaturePtr& GetFeature() const;
@@ -24,9 +29,17 @@ public:
     bool IsPreviewActive() const;
     void SetPreviewActive(bool active);
     
+    // Upper bound of the debounce; the actual delay follows the cost of recent previews
     void SetUpdateDelay(int milliseconds);
     int GetUpdateDelay() const;
     
+    // Smoothed wall time of recent previews in milliseconds
+    double GetPreviewCost() const;
+    
+    // Previews with unchanged inputs are served from the cache
+    void SetResultCache(const FeatureResultCachePtr& cache);
+    const FeatureResultCachePtr& GetResultCache() const;
+    
     // Callbacks
     void SetPreviewUpdateCallback(std::function<void(const cad_core::ShapePtr&)> callback);
     void SetPreviewClearCallback(std::function<void()> callback);
@@ -35,16 +48,41 @@ private slots:
     void OnUpdateTimer();
 
 private:
+    // A snapshot of the feature to preview, tagged with the generation it belongs to
+    struct PreviewJob {
+        FeaturePtr feature;
+        unsigned int generation = 0;
+        FeatureResultCache::Key key;
+    };
+    
     FeaturePtr m_feature;
     QTimer* m_updateTimer;
     bool m_previewActive;
     int m_updateDelay;
+    double m_previewCost;
+    FeatureResultCachePtr m_resultCache;
+    
+    // Bumped on every change; results and running jobs from older generations are stale
+    unsigned int m_generation;
+    std::atomic<unsigned int> m_latestGeneration;
+    
+    // Single worker thread; a newer job replaces one that has not started yet
+    std::thread m_worker;
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobCondition;
+    PreviewJob m_pendingJob;
+    bool m_stopping;
     
     std::function<void(const cad_core::ShapePtr&)> m_previewUpdateCallback;
     std::function<void()> m_previewClearCallback;
     
+    void InvalidatePendingPreview();
+    int ComputeDebounceDelay() const;
     void UpdatePreviewShape();
+    void OnPreviewFinished(unsigned int generation, const FeatureResultCache::Key& key,
+                           const cad_core::ShapePtr& shape, double cost);
     void ClearPreviewShape();
+    void WorkerLoop();
 };
 
-} // namespace cad_feature
\ No newline at end of file
+} // namespace cad_feature
@@ -30,14 +30,19 @@ public:
     
     // Feature interface
     cad_core::ShapePtr CreateShape() const override;
+    cad_core::ShapePtr CreatePreviewShape(const Message_ProgressRange& progress = Message_ProgressRange()) const override;
     bool ValidateParameters() const override;
+    std::vector<cad_sketch::SketchPtr> GetInputSketches() const override;
     std::shared_ptr<cad_core::ICommand> CreateCommand() const override;
+    FeaturePtr Clone() const override;
 
 private:
     cad_sketch::SketchPtr m_sketch;
     
     bool IsSketchValid() const;
     cad_core::ShapePtr RevolveSketch() const;
+    // Revolves a profile about the feature axis; shared by the exact and preview paths
+    cad_core::ShapePtr RevolveProfile(const TopoDS_Shape& profile, const Message_ProgressRange& progress) const;
 };
 
 using RevolveFeaturePtr = std::shared_ptr<RevolveFeature>;
@@ -41,6 +41,7 @@ ExtrudeFeature::ExtrudeFeature(const std::string& name) : Feature(FeatureType::E
 
 void ExtrudeFeature::SetSketch(const cad_sketch::SketchPtr& sketch) {
     m_sketch = sketch;
+    Touch();
 }
 
 const cad_sketch::SketchPtr& ExtrudeFeature::GetSketch() const {
@@ -85,6 +86,7 @@ bool ExtrudeFeature::GetMidplane() const {
 
 void ExtrudeFeature::SetSketchPlane(const gp_Pln& plane) {
     m_sketchPlane = plane;
+    Touch();
 }
 
 cad_core::ShapePtr ExtrudeFeature::CreateShape() const {
@@ -95,6 +97,33 @@ cad_core::ShapePtr ExtrudeFeature::CreateShape() const {
     return ExtrudeSketch();
 }
 
+cad_core::ShapePtr ExtrudeFeature::CreatePreviewShape(const Message_ProgressRange& progress) const {
+    if (!ValidateParameters() || progress.UserBreak()) {
+        return nullptr;
+    }
+    
+    try {
+        // 预览只拉伸轮廓边得到侧壁，不拼线框、不成面，也不做实体校验
+        TopoDS_Shape outline = BuildSketchOutline(m_sketch, m_sketchPlane);
+        if (outline.IsNull()) {
+            return nullptr;
+        }
+        
+        gp_Vec extrudeVector = gp_Vec(m_sketchPlane.Axis().Direction()) * GetDistance();
+        BRepPrimAPI_MakePrism prismMaker(outline, extrudeVector);
+        prismMaker.Build(progress);
+        
+        if (prismMaker.IsDone()) {
+            return std::make_shared<cad_core::Shape>(prismMaker.Shape());
+        }
+    }
+    catch (const Standard_Failure& e) {
+        return nullptr;
+    }
+    
+    return nullptr;
+}
+
 bool ExtrudeFeature::ValidateParameters() const {
     if (!IsSketchValid()) {
         return false;
@@ -115,11 +144,29 @@ bool ExtrudeFeature::ValidateParameters() const {
     return true;
 }
 
+std::vector<cad_sketch::SketchPtr> ExtrudeFeature::GetInputSketches() const {
+    if (m_sketch) {
+        return {m_sketch};
+    }
+    return {};
+}
+
+void ExtrudeFeature::HashInputs(std::size_t& seed) const {
+    Feature::HashInputs(seed);
+    HashPlane(seed, m_sketchPlane);
+}
+
 std::shared_ptr<cad_core::ICommand> ExtrudeFeature::CreateCommand() const {
     // For now, return a simple box command as placeholder
     return std::make_shared<cad_core::CreateBoxCommand>(GetDistance(), GetDistance(), GetDistance());
 }
 
+FeaturePtr ExtrudeFeature::Clone() const {
+    auto clone = std::make_shared<ExtrudeFeature>(*this);
+    clone->m_sketch = SnapshotSketch(m_sketch);
+    return clone;
+}
+
 bool ExtrudeFeature::IsSketchValid() const {
     return m_sketch && !m_sketch->IsEmpty();
 }
@@ -1,11 +1,18 @@
 ﻿#include "cad_feature/Feature.h"
+#include <BRep_Builder.hxx>
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <ElSLib.hxx>
+#include <Geom_Circle.hxx>
+#include <TopoDS_Compound.hxx>
+#include <gp_Ax2.hxx>
+#include <functional>
 
 namespace cad_feature {
 
 int Feature::s_nextId = 1;
 
 Feature::Feature(FeatureType type, const std::string& name)
-    : m_type(type), m_name(name), m_id(s_nextId++), m_state(FeatureState::Created), m_active(true) {
+    : m_type(type), m_name(name), m_id(s_nextId++), m_state(FeatureState::Created), m_active(true), m_revision(0) {
 }
 
 FeatureType Feature::GetType() const {
@@ -45,7 +52,12 @@ void Feature::SetActive(bool active) {
 }
 
 void Feature::SetParameter(const std::string& name, double value) {
+    auto it = m_parameters.find(name);
+    if (it != m_parameters.end() && it->second == value) {
+        return;
+    }
     m_parameters[name] = value;
+    Touch();
 }
 
 double Feature::GetParameter(const std::string& name) const {
@@ -56,11 +68,113 @@ double Feature::GetParameter(const std::string& name) const {
     return 0.0;
 }
 
+const std::map<std::string, double>& Feature::GetParameters() const {
+    return m_parameters;
+}
+
 bool Feature::HasParameter(const std::string& name) const {
     return m_parameters.find(name) != m_parameters.end();
 }
 
-cad_core::ShapePtr Feature::CreatePreviewShape() const {
+std::vector<cad_sketch::SketchPtr> Feature::GetInputSketches() const {
+    return {};
+}
+
+unsigned int Feature::GetRevision() const {
+    return m_revision;
+}
+
+void Feature::Touch() {
+    m_revision++;
+}
+
+std::size_t Feature::ComputeInputHash() const {
+    std::size_t seed = 0;
+    HashCombine(seed, static_cast<std::size_t>(m_type));
+    
+    // std::map 按名称有序，遍历顺序稳定
+    for (const auto& parameter : m_parameters) {
+        HashCombine(seed, std::hash<std::string>()(parameter.first));
+        HashValue(seed, parameter.second);
+    }
+    
+    HashInputs(seed);
+    return seed;
+}
+
+void Feature::HashInputs(std::size_t& seed) const {
+    for (const auto& sketch : GetInputSketches()) {
+        HashCombine(seed, sketch ? sketch->ComputeGeometryHash() : 0);
+    }
+}
+
+cad_sketch::SketchPtr Feature::SnapshotSketch(const cad_sketch::SketchPtr& sketch) {
+    return sketch ? sketch->CloneGeometry() : nullptr;
+}
+
+void Feature::HashCombine(std::size_t& seed, std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+void Feature::HashValue(std::size_t& seed, double value) {
+    HashCombine(seed, std::hash<double>()(value));
+}
+
+void Feature::HashPlane(std::size_t& seed, const gp_Pln& plane) {
+    const gp_Ax3& position = plane.Position();
+    HashValue(seed, position.Location().X());
+    HashValue(seed, position.Location().Y());
+    HashValue(seed, position.Location().Z());
+    HashValue(seed, position.XDirection().X());
+    HashValue(seed, position.XDirection().Y());
+    HashValue(seed, position.XDirection().Z());
+    HashValue(seed, position.Direction().X());
+    HashValue(seed, position.Direction().Y());
+    HashValue(seed, position.Direction().Z());
+}
+
+TopoDS_Shape Feature::BuildSketchOutline(const cad_sketch::SketchPtr& sketch, const gp_Pln& plane) {
+    if (!sketch || sketch->IsEmpty()) {
+        return TopoDS_Shape();
+    }
+    
+    BRep_Builder builder;
+    TopoDS_Compound outline;
+    builder.MakeCompound(outline);
+    
+    const gp_Dir& normal = plane.Axis().Direction();
+    const gp_Dir& xDirection = plane.XAxis().Direction();
+    
+    for (const auto& elem : sketch->GetElements()) {
+        if (elem->GetType() == cad_sketch::SketchElementType::Line) {
+            auto line = std::static_pointer_cast<cad_sketch::SketchLine>(elem);
+            gp_Pnt p1 = ElSLib::Value(line->GetStartPoint()->GetX(), line->GetStartPoint()->GetY(), plane);
+            gp_Pnt p2 = ElSLib::Value(line->GetEndPoint()->GetX(), line->GetEndPoint()->GetY(), plane);
+            if (!p1.IsEqual(p2, 1e-7)) {
+                builder.Add(outline, BRepBuilderAPI_MakeEdge(p1, p2).Edge());
+            }
+        }
+        else if (elem->GetType() == cad_sketch::SketchElementType::Circle) {
+            auto circle = std::static_pointer_cast<cad_sketch::SketchCircle>(elem);
+            gp_Pnt center = ElSLib::Value(circle->GetCenter()->GetX(), circle->GetCenter()->GetY(), plane);
+            Handle(Geom_Circle) geomCircle = new Geom_Circle(gp_Ax2(center, normal, xDirection), circle->GetRadius());
+            builder.Add(outline, BRepBuilderAPI_MakeEdge(geomCircle).Edge());
+        }
+        else if (elem->GetType() == cad_sketch::SketchElementType::Arc) {
+            // 圆的参数就是相对平面X方向的角度，与草图弧的起止角一致
+            auto arc = std::static_pointer_cast<cad_sketch::SketchArc>(elem);
+            gp_Pnt center = ElSLib::Value(arc->GetCenter()->GetX(), arc->GetCenter()->GetY(), plane);
+            Handle(Geom_Circle) geomCircle = new Geom_Circle(gp_Ax2(center, normal, xDirection), arc->GetRadius());
+            builder.Add(outline, BRepBuilderAPI_MakeEdge(geomCircle, arc->GetStartAngle(), arc->GetEndAngle()).Edge());
+        }
+    }
+    return outline;
+}
+
+cad_core::ShapePtr Feature::CreatePreviewShape(const Message_ProgressRange& progress) const {
+    if (progress.UserBreak()) {
+        return nullptr;
+    }
     return CreateShape();
 }
 
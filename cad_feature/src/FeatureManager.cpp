@@ -1,13 +1,17 @@
 ﻿#include "cad_feature/FeatureManager.h"
+#include <OSD_Parallel.hxx>
+#include <Standard_Failure.hxx>
 #include <algorithm>
 
 namespace cad_feature {
 
-FeatureManager::FeatureManager() {
+FeatureManager::FeatureManager()
+    : m_runParallel(true), m_resultCache(std::make_shared<FeatureResultCache>()) {
 }
 
 void FeatureManager::AddFeature(const FeaturePtr& feature) {
     m_features.push_back(feature);
+    m_records[feature->GetId()] = FeatureRecord();
     NotifyFeatureAdded(feature);
 }
 
@@ -15,12 +19,29 @@ void FeatureManager::RemoveFeature(const FeaturePtr& feature) {
     auto it = std::find(m_features.begin(), m_features.end(), feature);
     if (it != m_features.end()) {
         m_features.erase(it);
+        
+        // 下游失去了输入，需要重算；然后断开所有相关的边
+        const int id = feature->GetId();
+        PropagateDirty(m_downstream[id]);
+        for (int upstream : m_upstream[id]) {
+            m_downstream[upstream].erase(id);
+        }
+        for (int downstream : m_downstream[id]) {
+            m_upstream[downstream].erase(id);
+        }
+        m_upstream.erase(id);
+        m_downstream.erase(id);
+        m_records.erase(id);
+        
         NotifyFeatureRemoved(feature);
     }
 }
 
 void FeatureManager::ClearFeatures() {
     m_features.clear();
+    m_records.clear();
+    m_upstream.clear();
+    m_downstream.clear();
 }
 
 const std::vector<FeaturePtr>& FeatureManager::GetFeatures() const {
@@ -46,47 +67,217 @@ FeaturePtr FeatureManager::GetFeatureByName(const std::string& name) const {
 }
 
 bool FeatureManager::ExecuteFeature(const FeaturePtr& feature) {
-    if (!feature || !feature->IsActive()) {
+    if (!feature) {
         return false;
     }
     
-    if (!feature->ValidateParameters()) {
-        feature->SetState(FeatureState::Failed);
+    // 结果变了，下游都要重算
+    bool succeeded = RunFeature(feature);
+    PropagateDirty(m_downstream[feature->GetId()]);
+    return succeeded;
+}
+
+bool FeatureManager::ExecuteAllFeatures() {
+    for (auto& record : m_records) {
+        record.second.dirty = true;
+    }
+    return RebuildDirtyFeatures();
+}
+
+void FeatureManager::SetFeatureActive(const FeaturePtr& feature, bool active) {
+    feature->SetActive(active);
+    MarkFeatureDirty(feature);
+    NotifyFeatureUpdated(feature);
+}
+
+void FeatureManager::SetAllFeaturesActive(bool active) {
+    for (const auto& feature : m_features) {
+        feature->SetActive(active);
+        m_records[feature->GetId()].dirty = true;
+    }
+}
+
+bool FeatureManager::AddDependency(const FeaturePtr& downstream, const FeaturePtr& upstream) {
+    if (!downstream || !upstream || downstream == upstream) {
         return false;
     }
     
-    auto shape = feature->CreateShape();
-    if (shape) {
-        feature->SetState(FeatureState::Executed);
-        NotifyFeatureUpdated(feature);
-        return true;
-    } else {
-        feature->SetState(FeatureState::Failed);
+    // upstream 已经(间接)依赖 downstream 时再加这条边会成环
+    if (DependsOn(upstream->GetId(), downstream->GetId())) {
         return false;
     }
+    
+    m_upstream[downstream->GetId()].insert(upstream->GetId());
+    m_downstream[upstream->GetId()].insert(downstream->GetId());
+    MarkFeatureDirty(downstream);
+    return true;
 }
 
-bool FeatureManager::ExecuteAllFeatures() {
-    bool allSucceeded = true;
+void FeatureManager::RemoveDependency(const FeaturePtr& downstream, const FeaturePtr& upstream) {
+    if (!downstream || !upstream) {
+        return;
+    }
     
+    if (m_upstream[downstream->GetId()].erase(upstream->GetId()) > 0) {
+        m_downstream[upstream->GetId()].erase(downstream->GetId());
+        MarkFeatureDirty(downstream);
+    }
+}
+
+std::vector<FeaturePtr> FeatureManager::GetUpstreamFeatures(const FeaturePtr& feature) const {
+    std::vector<FeaturePtr> features;
+    auto it = feature ? m_upstream.find(feature->GetId()) : m_upstream.end();
+    if (it != m_upstream.end()) {
+        for (int id : it->second) {
+            features.push_back(GetFeatureById(id));
+        }
+    }
+    return features;
+}
+
+std::vector<FeaturePtr> FeatureManager::GetDownstreamFeatures(const FeaturePtr& feature) const {
+    std::vector<FeaturePtr> features;
+    auto it = feature ? m_downstream.find(feature->GetId()) : m_downstream.end();
+    if (it != m_downstream.end()) {
+        for (int id : it->second) {
+            features.push_back(GetFeatureById(id));
+        }
+    }
+    return features;
+}
+
+void FeatureManager::MarkFeatureDirty(const FeaturePtr& feature) {
+    if (feature) {
+        PropagateDirty({feature->GetId()});
+    }
+}
+
+void FeatureManager::MarkSketchDirty(const cad_sketch::SketchPtr& sketch) {
+    std::set<int> seeds;
+    for (const auto& feature : m_features) {
+        auto inputs = feature->GetInputSketches();
+        if (std::find(inputs.begin(), inputs.end(), sketch) != inputs.end()) {
+            seeds.insert(feature->GetId());
+        }
+    }
+    PropagateDirty(seeds);
+}
+
+bool FeatureManager::IsFeatureDirty(const FeaturePtr& feature) const {
+    return feature && NeedsRebuild(feature);
+}
+
+bool FeatureManager::RebuildDirtyFeatures() {
+    // 参数/输入修订号变化的特征也是重建的起点
+    std::set<int> seeds;
     for (const auto& feature : m_features) {
-        if (!ExecuteFeature(feature)) {
-            allSucceeded = false;
+        if (NeedsRebuild(feature)) {
+            seeds.insert(feature->GetId());
+        }
+    }
+    PropagateDirty(seeds);
+    
+    std::set<int> dirty;
+    for (const auto& record : m_records) {
+        if (record.second.dirty) {
+            dirty.insert(record.first);
+        }
+    }
+    
+    bool allSucceeded = true;
+    std::set<int> failed;
+    for (const auto& wave : GroupIntoWaves(SortTopologically(dirty))) {
+        // 串行准备：检查上游和参数，只有通过的特征进入并行阶段
+        std::vector<FeaturePtr> runnable;
+        for (const auto& feature : wave) {
+            if (!feature->IsActive()) {
+                continue;  // 保持脏标记，重新激活时再算
+            }
+            
+            const int id = feature->GetId();
+            bool upstreamFailed = false;
+            for (int upstream : m_upstream[id]) {
+                if (failed.count(upstream) || !m_records[upstream].result) {
+                    upstreamFailed = true;
+                    break;
+                }
+            }
+            
+            // 输入缺失时下游不执行（记录照样更新，避免下次重复尝试）
+            if (!BeginRun(feature) || upstreamFailed) {
+                if (upstreamFailed) {
+                    feature->SetState(FeatureState::Failed);
+                }
+                failed.insert(id);
+                allSucceeded = false;
+                continue;
+            }
+            runnable.push_back(feature);
+        }
+        
+        // 缓存命中的特征不再计算
+        const int count = static_cast<int>(runnable.size());
+        std::vector<cad_core::ShapePtr> shapes(count);
+        std::vector<char> cached(count, 0);
+        int missCount = 0;
+        for (int index = 0; index < count; index++) {
+            if (m_resultCache) {
+                shapes[index] = m_resultCache->Find(m_records[runnable[index]->GetId()].key);
+            }
+            cached[index] = shapes[index] ? 1 : 0;
+            missCount += cached[index] ? 0 : 1;
+        }
+        
+        // 同一波次的特征互不依赖，各自只读取自己的草图并构造独立的形状；
+        // 结果按下标写入，回调和状态修改留给下面的串行阶段
+        OSD_Parallel::For(0, count, [&](const Standard_Integer index) {
+            if (cached[index]) {
+                return;
+            }
+            try {
+                shapes[index] = runnable[index]->CreateShape();
+            } catch (const Standard_Failure& e) {
+                // 单个特征失败不影响同一波次的其他特征
+            }
+        }, !m_runParallel || missCount < 2);
+        
+        // 按拓扑顺序提交，结果与线程调度无关
+        for (int index = 0; index < count; index++) {
+            if (!cached[index] && shapes[index] && m_resultCache) {
+                m_resultCache->Insert(m_records[runnable[index]->GetId()].key, shapes[index]);
+            }
+            if (!FinishRun(runnable[index], shapes[index])) {
+                failed.insert(runnable[index]->GetId());
+                allSucceeded = false;
+            }
         }
     }
     
     return allSucceeded;
 }
 
-void FeatureManager::SetFeatureActive(const FeaturePtr& feature, bool active) {
-    feature->SetActive(active);
-    NotifyFeatureUpdated(feature);
+void FeatureManager::SetResultCache(const FeatureResultCachePtr& cache) {
+    m_resultCache = cache;
 }
 
-void FeatureManager::SetAllFeaturesActive(bool active) {
-    for (const auto& feature : m_features) {
-        feature->SetActive(active);
+const FeatureResultCachePtr& FeatureManager::GetResultCache() const {
+    return m_resultCache;
+}
+
+void FeatureManager::SetRunParallel(bool runParallel) {
+    m_runParallel = runParallel;
+}
+
+bool FeatureManager::GetRunParallel() const {
+    return m_runParallel;
+}
+
+cad_core::ShapePtr FeatureManager::GetFeatureResult(const FeaturePtr& feature) const {
+    if (!feature) {
+        return nullptr;
     }
+    auto it = m_records.find(feature->GetId());
+    return it != m_records.end() ? it->second.result : nullptr;
 }
 
 void FeatureManager::MoveFeatureUp(const FeaturePtr& feature) {
@@ -115,7 +306,9 @@ void FeatureManager::MoveFeatureToIndex(const FeaturePtr& feature, int newIndex)
 }
 
 void FeatureManager::UpdateFeature(const FeaturePtr& feature) {
-    ExecuteFeature(feature);
+    // 只重算该特征及其下游
+    MarkFeatureDirty(feature);
+    RebuildDirtyFeatures();
 }
 
 void FeatureManager::RebuildAllFeatures() {
@@ -150,6 +343,187 @@ int FeatureManager::FindFeatureIndex(const FeaturePtr& feature) const {
     return -1;
 }
 
+bool FeatureManager::NeedsRebuild(const FeaturePtr& feature) const {
+    auto it = m_records.find(feature->GetId());
+    if (it == m_records.end()) {
+        return true;
+    }
+    const FeatureRecord& record = it->second;
+    return record.dirty || !record.built || record.builtRevision != feature->GetRevision();
+}
+
+bool FeatureManager::DependsOn(int featureId, int upstreamId) const {
+    std::set<int> visited;
+    std::vector<int> stack = {featureId};
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        if (current == upstreamId) {
+            return true;
+        }
+        if (!visited.insert(current).second) {
+            continue;
+        }
+        auto it = m_upstream.find(current);
+        if (it != m_upstream.end()) {
+            stack.insert(stack.end(), it->second.begin(), it->second.end());
+        }
+    }
+    return false;
+}
+
+void FeatureManager::PropagateDirty(const std::set<int>& seeds) {
+    // 沿下游边扩散，已经是脏的节点不再重复展开
+    std::vector<int> stack(seeds.begin(), seeds.end());
+    std::set<int> visited;
+    while (!stack.empty()) {
+        int id = stack.back();
+        stack.pop_back();
+        if (!visited.insert(id).second) {
+            continue;
+        }
+        
+        auto record = m_records.find(id);
+        if (record != m_records.end()) {
+            record->second.dirty = true;
+        }
+        
+        auto it = m_downstream.find(id);
+        if (it != m_downstream.end()) {
+            stack.insert(stack.end(), it->second.begin(), it->second.end());
+        }
+    }
+}
+
+std::vector<FeaturePtr> FeatureManager::SortTopologically(const std::set<int>& featureIds) const {
+    // Kahn算法；同时就绪的特征按历史列表顺序，结果与集合遍历顺序无关
+    std::map<int, int> inDegree;
+    for (int id : featureIds) {
+        int count = 0;
+        auto it = m_upstream.find(id);
+        if (it != m_upstream.end()) {
+            for (int upstream : it->second) {
+                if (featureIds.count(upstream)) {
+                    count++;
+                }
+            }
+        }
+        inDegree[id] = count;
+    }
+    
+    std::map<int, int> listIndex;
+    for (int index = 0; index < static_cast<int>(m_features.size()); ++index) {
+        listIndex[m_features[index]->GetId()] = index;
+    }
+    
+    std::set<std::pair<int, int>> ready;  // (列表位置, 特征ID)
+    for (const auto& pair : inDegree) {
+        if (pair.second == 0 && listIndex.count(pair.first)) {
+            ready.insert({listIndex[pair.first], pair.first});
+        }
+    }
+    
+    std::vector<FeaturePtr> order;
+    while (!ready.empty()) {
+        auto next = *ready.begin();
+        ready.erase(ready.begin());
+        order.push_back(m_features[next.first]);
+        
+        auto it = m_downstream.find(next.second);
+        if (it == m_downstream.end()) {
+            continue;
+        }
+        for (int downstream : it->second) {
+            auto degree = inDegree.find(downstream);
+            if (degree != inDegree.end() && --degree->second == 0 && listIndex.count(downstream)) {
+                ready.insert({listIndex[downstream], downstream});
+            }
+        }
+    }
+    return order;
+}
+
+std::vector<std::vector<FeaturePtr>> FeatureManager::GroupIntoWaves(const std::vector<FeaturePtr>& order) const {
+    // 波次 = 在本次重建集合内的最长上游链长度；order 已是拓扑序，上游总是先被处理
+    std::map<int, int> level;
+    std::vector<std::vector<FeaturePtr>> waves;
+    for (const auto& feature : order) {
+        int featureLevel = 0;
+        auto it = m_upstream.find(feature->GetId());
+        if (it != m_upstream.end()) {
+            for (int upstream : it->second) {
+                auto upstreamLevel = level.find(upstream);
+                if (upstreamLevel != level.end()) {
+                    featureLevel = std::max(featureLevel, upstreamLevel->second + 1);
+                }
+            }
+        }
+        level[feature->GetId()] = featureLevel;
+        
+        if (featureLevel >= static_cast<int>(waves.size())) {
+            waves.resize(featureLevel + 1);
+        }
+        waves[featureLevel].push_back(feature);
+    }
+    return waves;
+}
+
+bool FeatureManager::RunFeature(const FeaturePtr& feature) {
+    if (!feature->IsActive() || !BeginRun(feature)) {
+        return false;
+    }
+    
+    const FeatureResultCache::Key key = m_records[feature->GetId()].key;
+    cad_core::ShapePtr shape = m_resultCache ? m_resultCache->Find(key) : nullptr;
+    if (!shape) {
+        try {
+            shape = feature->CreateShape();
+        } catch (const Standard_Failure& e) {
+            shape = nullptr;
+        }
+        if (shape && m_resultCache) {
+            m_resultCache->Insert(key, shape);
+        }
+    }
+    return FinishRun(feature, shape);
+}
+
+bool FeatureManager::BeginRun(const FeaturePtr& feature) {
+    FeatureRecord& record = m_records[feature->GetId()];
+    record.built = true;
+    record.dirty = false;
+    record.builtRevision = feature->GetRevision();
+    record.result.reset();
+    
+    // 上游按ID有序，键的组合顺序固定
+    std::vector<std::size_t> upstreamHashes;
+    auto upstream = m_upstream.find(feature->GetId());
+    if (upstream != m_upstream.end()) {
+        for (int id : upstream->second) {
+            upstreamHashes.push_back(m_records[id].key.hash);
+        }
+    }
+    record.key = FeatureResultCache::MakeKey(*feature, false, upstreamHashes);
+    
+    if (!feature->ValidateParameters()) {
+        feature->SetState(FeatureState::Failed);
+        return false;
+    }
+    return true;
+}
+
+bool FeatureManager::FinishRun(const FeaturePtr& feature, const cad_core::ShapePtr& shape) {
+    if (shape) {
+        m_records[feature->GetId()].result = shape;
+        feature->SetState(FeatureState::Executed);
+        NotifyFeatureUpdated(feature);
+        return true;
+    } else {
+        feature->SetState(FeatureState::Failed);
+        return false;
+    }
+}
+
 void FeatureManager::NotifyFeatureAdded(const FeaturePtr& feature) {
     if (m_featureAddedCallback) {
         m_featureAddedCallback(feature);
@@ -0,0 +1,154 @@
+﻿#include "cad_feature/FeatureResultCache.h"
+#include <TopAbs_ShapeEnum.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+
+namespace cad_feature {
+
+namespace {
+
+// 拓扑元素的粗略内存占用（含几何和曲面/曲线句柄），只用于预算控制
+const std::size_t BYTES_PER_FACE = 2048;
+const std::size_t BYTES_PER_EDGE = 512;
+const std::size_t BYTES_PER_VERTEX = 128;
+
+void HashCombine(std::size_t& seed, std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+} // anonymous namespace
+
+FeatureResultCache::FeatureResultCache(std::size_t memoryBudget)
+    : m_memoryBudget(memoryBudget), m_memoryUsage(0), m_hitCount(0), m_missCount(0) {
+}
+
+bool FeatureResultCache::Key::operator==(const Key& other) const {
+    return hash == other.hash && preview == other.preview && type == other.type &&
+           inputHash == other.inputHash && parameters == other.parameters &&
+           upstreamHashes == other.upstreamHashes;
+}
+
+FeatureResultCache::Key FeatureResultCache::MakeKey(const Feature& feature, bool preview,
+                                                    const std::vector<std::size_t>& upstreamHashes) {
+    Key key;
+    key.preview = preview;
+    key.type = feature.GetType();
+    key.parameters = feature.GetParameters();
+    key.inputHash = feature.ComputeInputHash();
+    key.upstreamHashes = upstreamHashes;
+    
+    key.hash = preview ? 1 : 0;
+    HashCombine(key.hash, key.inputHash);
+    for (std::size_t upstreamHash : upstreamHashes) {
+        HashCombine(key.hash, upstreamHash);
+    }
+    return key;
+}
+
+cad_core::ShapePtr FeatureResultCache::Find(const Key& key) {
+    auto it = m_index.find(key.hash);
+    if (it == m_index.end() || it->second->key != key) {
+        m_missCount++;
+        return nullptr;
+    }
+    
+    m_hitCount++;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->shape;
+}
+
+void FeatureResultCache::Insert(const Key& key, const cad_core::ShapePtr& shape) {
+    if (!shape) {
+        return;
+    }
+    
+    // 同一哈希只保留一个条目：碰撞时新结果替换旧结果
+    auto existing = m_index.find(key.hash);
+    if (existing != m_index.end()) {
+        m_memoryUsage -= existing->second->bytes;
+        m_entries.erase(existing->second);
+        m_index.erase(existing);
+    }
+    
+    std::size_t bytes = EstimateMemory(shape);
+    if (bytes > m_memoryBudget) {
+        return;  // 单个结果就超出预算时不缓存
+    }
+    
+    m_entries.push_front({key, shape, bytes});
+    m_index[key.hash] = m_entries.begin();
+    m_memoryUsage += bytes;
+    EvictToBudget();
+}
+
+void FeatureResultCache::Remove(const Key& key) {
+    auto it = m_index.find(key.hash);
+    if (it == m_index.end() || it->second->key != key) {
+        return;
+    }
+    
+    m_memoryUsage -= it->second->bytes;
+    m_entries.erase(it->second);
+    m_index.erase(it);
+}
+
+void FeatureResultCache::Clear() {
+    m_entries.clear();
+    m_index.clear();
+    m_memoryUsage = 0;
+}
+
+void FeatureResultCache::SetMemoryBudget(std::size_t bytes) {
+    m_memoryBudget = bytes;
+    EvictToBudget();
+}
+
+std::size_t FeatureResultCache::GetMemoryBudget() const {
+    return m_memoryBudget;
+}
+
+std::size_t FeatureResultCache::GetMemoryUsage() const {
+    return m_memoryUsage;
+}
+
+int FeatureResultCache::GetEntryCount() const {
+    return static_cast<int>(m_entries.size());
+}
+
+int FeatureResultCache::GetHitCount() const {
+    return m_hitCount;
+}
+
+int FeatureResultCache::GetMissCount() const {
+    return m_missCount;
+}
+
+void FeatureResultCache::EvictToBudget() {
+    while (m_memoryUsage > m_memoryBudget && !m_entries.empty()) {
+        const Entry& oldest = m_entries.back();
+        m_memoryUsage -= oldest.bytes;
+        m_index.erase(oldest.key.hash);
+        m_entries.pop_back();
+    }
+}
+
+std::size_t FeatureResultCache::EstimateMemory(const cad_core::ShapePtr& shape) {
+    const TopoDS_Shape& occtShape = shape->GetOCCTShape();
+    if (occtShape.IsNull()) {
+        return sizeof(cad_core::Shape);
+    }
+    
+    TopTools_IndexedMapOfShape faces;
+    TopTools_IndexedMapOfShape edges;
+    TopTools_IndexedMapOfShape vertices;
+    TopExp::MapShapes(occtShape, TopAbs_FACE, faces);
+    TopExp::MapShapes(occtShape, TopAbs_EDGE, edges);
+    TopExp::MapShapes(occtShape, TopAbs_VERTEX, vertices);
+    
+    return sizeof(cad_core::Shape)
+        + faces.Extent() * BYTES_PER_FACE
+        + edges.Extent() * BYTES_PER_EDGE
+        + vertices.Extent() * BYTES_PER_VERTEX;
+}
+
+} // namespace cad_feature
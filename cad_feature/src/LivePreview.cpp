@@ -1,16 +1,71 @@
 ﻿#include "cad_feature/LivePreview.h"
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressScope.hxx>
+#include <Standard_Failure.hxx>
+#include <algorithm>
+#include <chrono>
 
 namespace cad_feature {
 
-LivePreview::LivePreview(QObject* parent) : QObject(parent), m_previewActive(false), m_updateDelay(500) {
+namespace {
+
+// Shortest debounce, about one frame, used while previews are cheap
+const int MIN_UPDATE_DELAY_MS = 16;
+
+// Weight of the newest sample in the smoothed preview cost
+const double COST_SMOOTHING = 0.5;
+
+// Reports a break as soon as the preview it belongs to has been superseded
+class GenerationProgress : public Message_ProgressIndicator {
+public:
+    GenerationProgress(const std::atomic<unsigned int>& latestGeneration, unsigned int generation)
+        : m_latestGeneration(latestGeneration), m_generation(generation) {
+    }
+    
+    Standard_Boolean UserBreak() override {
+        return m_latestGeneration.load() != m_generation;
+    }
+    
+    void Show(const Message_ProgressScope&, const Standard_Boolean) override {
+    }
+
+private:
+    const std::atomic<unsigned int>& m_latestGeneration;
+    unsigned int m_generation;
+};
+
+} // anonymous namespace
+
+LivePreview::LivePreview(QObject* parent)
+    : QObject(parent), m_previewActive(false), m_updateDelay(500), m_previewCost(0.0),
+      m_generation(0), m_latestGeneration(0), m_stopping(false) {
     m_updateTimer = new QTimer(this);
     m_updateTimer->setSingleShot(true);
     
     connect(m_updateTimer, &QTimer::timeout, this, &LivePreview::OnUpdateTimer);
+    
+    m_worker = std::thread(&LivePreview::WorkerLoop, this);
+}
+
+LivePreview::~LivePreview() {
+    // Cancel the running preview and wait for the worker before this object goes away,
+    // so no queued result can reach a destroyed preview
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_stopping = true;
+        m_pendingJob = PreviewJob();
+    }
+    m_latestGeneration.store(++m_generation);
+    m_jobCondition.notify_all();
+    
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
 }
 
 void LivePreview::SetFeature(const FeaturePtr& feature) {
     m_feature = feature;
+    InvalidatePendingPreview();
     
     if (m_previewActive) {
         UpdatePreview();
@@ -29,6 +84,7 @@ void LivePreview::StartPreview() {
 void LivePreview::StopPreview() {
     m_previewActive = false;
     m_updateTimer->stop();
+    InvalidatePendingPreview();
     ClearPreviewShape();
 }
 
@@ -37,8 +93,11 @@ void LivePreview::UpdatePreview() {
         return;
     }
     
+    // The parameters changed, so whatever is being computed now is stale
+    InvalidatePendingPreview();
+    
     // Restart the timer to delay the update
-    m_updateTimer->start(m_updateDelay);
+    m_updateTimer->start(ComputeDebounceDelay());
 }
 
 bool LivePreview::IsPreviewActive() const {
@@ -61,6 +120,18 @@ int LivePreview::GetUpdateDelay() const {
     return m_updateDelay;
 }
 
+double LivePreview::GetPreviewCost() const {
+    return m_previewCost;
+}
+
+void LivePreview::SetResultCache(const FeatureResultCachePtr& cache) {
+    m_resultCache = cache;
+}
+
+const FeatureResultCachePtr& LivePreview::GetResultCache() const {
+    return m_resultCache;
+}
+
 void LivePreview::SetPreviewUpdateCallback(std::function<void(const cad_core::ShapePtr&)> callback) {
     m_previewUpdateCallback = callback;
 }
@@ -75,6 +146,21 @@ void LivePreview::OnUpdateTimer() {
     }
 }
 
+void LivePreview::InvalidatePendingPreview() {
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_pendingJob = PreviewJob();
+    }
+    m_latestGeneration.store(++m_generation);
+}
+
+int LivePreview::ComputeDebounceDelay() const {
+    // Cheap previews follow the input within a frame; an expensive one waits about as
+    // long as it takes, so a stream of edits does not start a job for every change
+    int delay = static_cast<int>(m_previewCost);
+    return std::max(MIN_UPDATE_DELAY_MS, std::min(delay, m_updateDelay));
+}
+
 void LivePreview::UpdatePreviewShape() {
     if (!m_feature) {
         return;
@@ -83,12 +169,48 @@ void LivePreview::UpdatePreviewShape() {
     // Set feature state to previewing
     m_feature->SetState(FeatureState::Previewing);
     
-    // Create preview shape
-    auto previewShape = m_feature->CreatePreviewShape();
+    PreviewJob job;
+    job.generation = m_generation;
+    
+    // Unchanged inputs are answered from the cache without touching the worker
+    if (m_resultCache) {
+        job.key = FeatureResultCache::MakeKey(*m_feature, true);
+        auto cachedShape = m_resultCache->Find(job.key);
+        if (cachedShape) {
+            if (m_previewUpdateCallback) {
+                m_previewUpdateCallback(cachedShape);
+            }
+            return;
+        }
+    }
+    
+    // The worker computes on a snapshot that also copies the input sketches, so the
+    // panel can keep editing the feature and the sketch tools can keep moving points
+    job.feature = m_feature->Clone();
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_pendingJob = std::move(job);
+    }
+    m_jobCondition.notify_one();
+}
+
+void LivePreview::OnPreviewFinished(unsigned int generation, const FeatureResultCache::Key& key,
+                                    const cad_core::ShapePtr& shape, double cost) {
+    if (generation != m_generation || !m_previewActive) {
+        return;  // superseded by a newer change
+    }
+    
+    m_previewCost = m_previewCost > 0.0
+        ? (1.0 - COST_SMOOTHING) * m_previewCost + COST_SMOOTHING * cost
+        : cost;
+    
+    if (shape && m_resultCache) {
+        m_resultCache->Insert(key, shape);
+    }
     
     // Notify callback
     if (m_previewUpdateCallback) {
-        m_previewUpdateCallback(previewShape);
+        m_previewUpdateCallback(shape);
     }
 }
 
@@ -98,6 +220,43 @@ void LivePreview::ClearPreviewShape() {
     }
 }
 
+void LivePreview::WorkerLoop() {
+    for (;;) {
+        PreviewJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_jobMutex);
+            m_jobCondition.wait(lock, [this]() { return m_stopping || m_pendingJob.feature; });
+            if (m_stopping) {
+                return;
+            }
+            job = std::move(m_pendingJob);
+            m_pendingJob = PreviewJob();
+        }
+        
+        Handle(GenerationProgress) progress = new GenerationProgress(m_latestGeneration, job.generation);
+        if (progress->UserBreak()) {
+            continue;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        cad_core::ShapePtr shape;
+        try {
+            shape = job.feature->CreatePreviewShape(progress->Start());
+        } catch (const Standard_Failure& e) {
+            shape = nullptr;
+        }
+        double cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        
+        if (progress->UserBreak()) {
+            continue;  // cancelled or superseded while running; the result may be partial
+        }
+        
+        QMetaObject::invokeMethod(this, [this, job, shape, cost]() {
+            OnPreviewFinished(job.generation, job.key, shape, cost);
+        }, Qt::QueuedConnection);
+    }
+}
+
 } // namespace cad_feature
 
 #include "LivePreview.moc"
\ No newline at end of file
@@ -68,17 +68,20 @@ LoftFeature::LoftFeature(const std::string& name) : Feature(FeatureType::Loft, n
 
 void LoftFeature::AddSection(const cad_sketch::SketchPtr& section) {
     m_sections.push_back(section);
+    Touch();
 }
 
 void LoftFeature::RemoveSection(const cad_sketch::SketchPtr& section) {
     auto it = std::find(m_sections.begin(), m_sections.end(), section);
     if (it != m_sections.end()) {
         m_sections.erase(it);
+        Touch();
     }
 }
 
 void LoftFeature::ClearSections() {
     m_sections.clear();
+    Touch();
 }
 
 const std::vector<cad_sketch::SketchPtr>& LoftFeature::GetSections() const {
@@ -91,17 +94,20 @@ int LoftFeature::GetSectionCount() const {
 
 void LoftFeature::AddGuideCurve(const cad_sketch::SketchPtr& guide) {
     m_guideCurves.push_back(guide);
+    Touch();
 }
 
 void LoftFeature::RemoveGuideCurve(const cad_sketch::SketchPtr& guide) {
     auto it = std::find(m_guideCurves.begin(), m_guideCurves.end(), guide);
     if (it != m_guideCurves.end()) {
         m_guideCurves.erase(it);
+        Touch();
     }
 }
 
 void LoftFeature::ClearGuideCurves() {
     m_guideCurves.clear();
+    Touch();
 }
 
 const std::vector<cad_sketch::SketchPtr>& LoftFeature::GetGuideCurves() const {
@@ -144,6 +150,36 @@ cad_core::ShapePtr LoftFeature::CreateShape() const {
     return LoftSections();
 }
 
+cad_core::ShapePtr LoftFeature::CreatePreviewShape(const Message_ProgressRange& progress) const {
+    if (!ValidateParameters() || progress.UserBreak()) {
+        return nullptr;
+    }
+
+    try {
+        // 预览用直纹放样：截面之间直接连直纹面，不拟合B样条，也不成实体
+        BRepOffsetAPI_ThruSections thruSections(Standard_False, Standard_True, 1.0e-6);
+
+        for (const auto& sectionSketch : m_sections) {
+            TopoDS_Wire wire = ConvertSketchToWire(sectionSketch);
+            if (wire.IsNull()) {
+                return nullptr;
+            }
+            thruSections.AddWire(wire);
+        }
+
+        thruSections.Build(progress);
+
+        if (thruSections.IsDone()) {
+            return std::make_shared<cad_core::Shape>(thruSections.Shape());
+        }
+    }
+    catch (const Standard_Failure& e) {
+        return nullptr;
+    }
+
+    return nullptr;
+}
+
 bool LoftFeature::ValidateParameters() const {
     if (!AreSectionsValid()) {
         return false;
@@ -156,11 +192,34 @@ bool LoftFeature::ValidateParameters() const {
     return true;
 }
 
+std::vector<cad_sketch::SketchPtr> LoftFeature::GetInputSketches() const {
+    std::vector<cad_sketch::SketchPtr> sketches(m_sections.begin(), m_sections.end());
+    sketches.insert(sketches.end(), m_guideCurves.begin(), m_guideCurves.end());
+    return sketches;
+}
+
+void LoftFeature::HashInputs(std::size_t& seed) const {
+    // 截面和引导线拼在同一个列表里，混入截面数量以区分两者的分界
+    HashCombine(seed, m_sections.size());
+    Feature::HashInputs(seed);
+}
+
 std::shared_ptr<cad_core::ICommand> LoftFeature::CreateCommand() const {
     // For now, return a simple sphere command as placeholder
     return std::make_shared<cad_core::CreateSphereCommand>(5.0);
 }
 
+FeaturePtr LoftFeature::Clone() const {
+    auto clone = std::make_shared<LoftFeature>(*this);
+    for (auto& section : clone->m_sections) {
+        section = SnapshotSketch(section);
+    }
+    for (auto& guide : clone->m_guideCurves) {
+        guide = SnapshotSketch(guide);
+    }
+    return clone;
+}
+
 bool LoftFeature::AreSectionsValid() const {
     for (const auto& section : m_sections) {
         if (!section || section->IsEmpty()) {
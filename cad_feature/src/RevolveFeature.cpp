@@ -1,6 +1,14 @@
 ﻿#include "cad_feature/RevolveFeature.h"
 #include "cad_core/CreateCylinderCommand.h"
 #include <BRepPrimAPI_MakeRevol.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepBuilderAPI_MakeWire.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <TopoDS.hxx>
+#include <gp_Trsf.hxx>
+#include <Standard_Failure.hxx>
 #include <gp_Ax1.hxx>
 #include <gp_Dir.hxx>
 #include <cmath>
@@ -31,6 +39,7 @@ namespace cad_feature {
 
     void RevolveFeature::SetSketch(const cad_sketch::SketchPtr& sketch) {
         m_sketch = sketch;
+        Touch();
     }
 
     const cad_sketch::SketchPtr& RevolveFeature::GetSketch() const {
@@ -85,6 +94,24 @@ namespace cad_feature {
         return RevolveSketch();
     }
 
+    cad_core::ShapePtr RevolveFeature::CreatePreviewShape(const Message_ProgressRange& progress) const {
+        if (!ValidateParameters() || progress.UserBreak()) {
+            return nullptr;
+        }
+
+        try {
+            // 预览只旋转轮廓边得到回转曲面，不成面也不做实体校验
+            TopoDS_Shape outline = BuildSketchOutline(m_sketch, m_sketch->GetPlane());
+            if (outline.IsNull()) {
+                return nullptr;
+            }
+            return RevolveProfile(outline, progress);
+        }
+        catch (const Standard_Failure& e) {
+            return nullptr;
+        }
+    }
+
     bool RevolveFeature::ValidateParameters() const {
         if (!IsSketchValid()) {
             return false;
@@ -105,11 +132,24 @@ namespace cad_feature {
         return true;
     }
 
+    std::vector<cad_sketch::SketchPtr> RevolveFeature::GetInputSketches() const {
+        if (m_sketch) {
+            return {m_sketch};
+        }
+        return {};
+    }
+
     std::shared_ptr<cad_core::ICommand> RevolveFeature::CreateCommand() const {
         // For now, return a simple cylinder command as placeholder
         return std::make_shared<cad_core::CreateCylinderCommand>(5.0, 10.0);
     }
 
+    FeaturePtr RevolveFeature::Clone() const {
+        auto clone = std::make_shared<RevolveFeature>(*this);
+        clone->m_sketch = SnapshotSketch(m_sketch);
+        return clone;
+    }
+
     bool RevolveFeature::IsSketchValid() const {
         return m_sketch && !m_sketch->IsEmpty();
     }
@@ -120,22 +160,59 @@ namespace cad_feature {
         }
 
         try {
-            // In a real implementation, this would:
-            // 1. Convert sketch elements to OCCT wire/face
-            // 2. Create revolution axis from origin and direction
-            // 3. Use BRepPrimAPI_MakeRevol to create the solid
-
-            // For now, return a simple shape as placeholder
-            auto shape = std::make_shared<cad_core::Shape>();
+            // 与预览相同的轮廓边，这里连成闭合线框再成面，旋转得到实体
+            TopoDS_Shape outline = BuildSketchOutline(m_sketch, m_sketch->GetPlane());
+            if (outline.IsNull()) {
+                return nullptr;
+            }
+
+            // 草图元素不一定首尾相接地排列，按列表加入由 MakeWire 自行排序
+            TopTools_ListOfShape edges;
+            for (TopExp_Explorer explorer(outline, TopAbs_EDGE); explorer.More(); explorer.Next()) {
+                edges.Append(explorer.Current());
+            }
+            BRepBuilderAPI_MakeWire wireMaker;
+            wireMaker.Add(edges);
+            if (!wireMaker.IsDone() || !wireMaker.Wire().Closed()) {
+                // 线框无效或未闭合，无法成面
+                return nullptr;
+            }
+
+            BRepBuilderAPI_MakeFace faceMaker(m_sketch->GetPlane(), wireMaker.Wire(), Standard_True);
+            if (!faceMaker.IsDone()) {
+                return nullptr;
+            }
+
+            return RevolveProfile(faceMaker.Face(), Message_ProgressRange());
+        }
+        catch (const Standard_Failure& e) {
+            return nullptr;
+        }
+    }
 
-            // Placeholder: create a simple cylinder-like shape
-            // In real implementation, this would properly revolve the sketch
+    cad_core::ShapePtr RevolveFeature::RevolveProfile(const TopoDS_Shape& profile,
+                                                      const Message_ProgressRange& progress) const {
+        double ax, ay, az, ox, oy, oz;
+        GetAxis(ax, ay, az);
+        GetAxisOrigin(ox, oy, oz);
+        gp_Ax1 axis(gp_Pnt(ox, oy, oz), gp_Dir(ax, ay, az));
 
-            return shape;
+        // 对称旋转时先把轮廓转回半个角度
+        TopoDS_Shape placed = profile;
+        double angle = GetAngle();
+        if (GetMidplane()) {
+            gp_Trsf rotation;
+            rotation.SetRotation(axis, -0.5 * angle);
+            placed = BRepBuilderAPI_Transform(profile, rotation, Standard_False).Shape();
         }
-        catch (...) {
-            return nullptr;
+
+        BRepPrimAPI_MakeRevol revolMaker(placed, axis, angle);
+        revolMaker.Build(progress);
+
+        if (revolMaker.IsDone()) {
+            return std::make_shared<cad_core::Shape>(revolMaker.Shape());
         }
+        return nullptr;
     }
 
 } // namespace cad_feature
\ No newline at end of file
@@ -7,9 +7,58 @@
 #include <gp_Ax2.hxx>
 #include <cmath>
 #include <ElSLib.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepBuilderAPI_MakePolygon.hxx>
+#include <BRepTools_WireExplorer.hxx>
 
 namespace cad_feature {
 
+namespace {
+
+// 预览时每条曲线路径边离散成的直线段数
+const int PREVIEW_CURVE_SEGMENTS = 12;
+
+// 把路径线框离散成折线：直线边保持原样，曲线边按固定段数取点
+TopoDS_Wire ApproximatePathWire(const TopoDS_Wire& path) {
+    BRepBuilderAPI_MakePolygon polygon;
+    const bool closed = path.Closed() == Standard_True;
+    gp_Pnt firstPoint;
+    gp_Pnt lastPoint;
+    bool hasPoint = false;
+    
+    // 闭合路径回到起点时不再加点，最后由 Close() 连回第一个顶点
+    auto addPoint = [&](const gp_Pnt& point) {
+        if (!hasPoint) {
+            firstPoint = point;
+        } else if (point.IsEqual(lastPoint, 1e-7) || (closed && point.IsEqual(firstPoint, 1e-7))) {
+            return;
+        }
+        polygon.Add(point);
+        lastPoint = point;
+        hasPoint = true;
+    };
+    
+    for (BRepTools_WireExplorer explorer(path); explorer.More(); explorer.Next()) {
+        BRepAdaptor_Curve curve(explorer.Current());
+        const int segments = curve.GetType() == GeomAbs_Line ? 1 : PREVIEW_CURVE_SEGMENTS;
+        const bool reversed = explorer.Current().Orientation() == TopAbs_REVERSED;
+        const double first = curve.FirstParameter();
+        const double last = curve.LastParameter();
+        
+        for (int i = 0; i <= segments; i++) {
+            double t = static_cast<double>(i) / segments;
+            addPoint(curve.Value(reversed ? last + t * (first - last) : first + t * (last - first)));
+        }
+    }
+    
+    if (closed) {
+        polygon.Close();
+    }
+    return polygon.Wire();
+}
+
+} // anonymous namespace
+
 // 将草图对象转换为OpenCASCADE的线框
 TopoDS_Wire ConvertSketchToWire(const cad_sketch::SketchPtr& sketch, const gp_Pln& plane) {
     if (!sketch || sketch->IsEmpty()) {
@@ -61,14 +110,17 @@ SweepFeature::SweepFeature(const std::string& name) : Feature(FeatureType::Sweep
 
 void SweepFeature::SetProfilePlane(const gp_Pln& plane) {
     m_profilePlane = plane;
+    Touch();
 }
 
 void SweepFeature::SetPathPlane(const gp_Pln& plane) {
     m_pathPlane = plane;
+    Touch();
 }
 
 void SweepFeature::SetProfile(const cad_sketch::SketchPtr& profile) {
     m_profile = profile;
+    Touch();
 }
 
 const cad_sketch::SketchPtr& SweepFeature::GetProfile() const {
@@ -77,6 +129,7 @@ const cad_sketch::SketchPtr& SweepFeature::GetProfile() const {
 
 void SweepFeature::SetPath(const cad_sketch::SketchPtr& path) {
     m_path = path;
+    Touch();
 }
 
 const cad_sketch::SketchPtr& SweepFeature::GetPath() const {
@@ -117,6 +170,37 @@ cad_core::ShapePtr SweepFeature::CreateShape() const {
     return SweepProfile();
 }
 
+cad_core::ShapePtr SweepFeature::CreatePreviewShape(const Message_ProgressRange& progress) const {
+    if (!ValidateParameters() || progress.UserBreak()) {
+        return nullptr;
+    }
+
+    try {
+        // 预览用粗离散扫掠：路径折线化，截面只取轮廓边，得到分段的管状曲面
+        TopoDS_Shape profileOutline = BuildSketchOutline(m_profile, m_profilePlane);
+        TopoDS_Wire pathWire = ConvertSketchToWire(m_path, m_pathPlane);
+        if (profileOutline.IsNull() || pathWire.IsNull()) {
+            return nullptr;
+        }
+
+        TopoDS_Wire coarsePath = ApproximatePathWire(pathWire);
+        if (progress.UserBreak()) {
+            return nullptr;
+        }
+
+        BRepOffsetAPI_MakePipe pipeMaker(coarsePath, profileOutline);
+        pipeMaker.Build(progress);
+
+        if (pipeMaker.IsDone()) {
+            return std::make_shared<cad_core::Shape>(pipeMaker.Shape());
+        }
+    } catch (const Standard_Failure& e) {
+        return nullptr;
+    }
+
+    return nullptr;
+}
+
 bool SweepFeature::ValidateParameters() const {
     if (!IsProfileValid() || !IsPathValid()) {
         return false;
@@ -130,11 +214,35 @@ bool SweepFeature::ValidateParameters() const {
     return true;
 }
 
+std::vector<cad_sketch::SketchPtr> SweepFeature::GetInputSketches() const {
+    std::vector<cad_sketch::SketchPtr> sketches;
+    if (m_profile) {
+        sketches.push_back(m_profile);
+    }
+    if (m_path) {
+        sketches.push_back(m_path);
+    }
+    return sketches;
+}
+
+void SweepFeature::HashInputs(std::size_t& seed) const {
+    Feature::HashInputs(seed);
+    HashPlane(seed, m_profilePlane);
+    HashPlane(seed, m_pathPlane);
+}
+
 std::shared_ptr<cad_core::ICommand> SweepFeature::CreateCommand() const {
     // For now, return a simple box command as placeholder
     return std::make_shared<cad_core::CreateBoxCommand>(10.0, 10.0, 10.0);
 }
 
+FeaturePtr SweepFeature::Clone() const {
+    auto clone = std::make_shared<SweepFeature>(*this);
+    clone->m_profile = SnapshotSketch(m_profile);
+    clone->m_path = SnapshotSketch(m_path);
+    return clone;
+}
+
 bool SweepFeature::IsProfileValid() const {
     return m_profile && !m_profile->IsEmpty();
 }
@@ -34,6 +34,10 @@ public:
     bool IsActive() const;
     void SetActive(bool active);
     
+    // 尺寸约束（距离、角度、半径、直径）的目标值，角度为弧度
+    double GetValue() const;
+    void SetValue(double value);
+    
     virtual bool IsValid() const = 0;
     virtual std::string GetDescription() const = 0;
     virtual double GetError() const = 0;
@@ -43,6 +47,7 @@ protected:
     int m_id;
     std::vector<SketchElementPtr> m_elements;
     bool m_active;
+    double m_value;
     
     static int s_nextId;
 };
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "Constraint.h"
+#include "ConstraintSystem.h"
 #include "SketchElement.h"
+#include "SketchPoint.h"
+#include "SparseLDL.h"
+#include <map>
+#include <set>
 #include <vector>
 #include <memory>
 
@@ -18,7 +23,27 @@ public:
     
     const std::vector<ConstraintPtr>& GetConstraints() const;
     
+    // 求解全部约束：按互不共享参数的连通分量拆开，各分量并行求解
     bool Solve();
+    
+    // 标记被编辑过的元素或约束（如修改了尺寸值），SolveModified 只重新求解它们所在的分量
+    void MarkElementModified(const SketchElementPtr& element);
+    void MarkConstraintModified(const ConstraintPtr& constraint);
+    bool SolveModified();
+    
+    // 拖动求解：只建一次点所在分量的方程组，被拖点作为软约束拉向鼠标位置，
+    // 每帧从上一帧结果热启动并限制迭代次数；松开鼠标时 EndDrag 做一次完整精确求解
+    bool BeginDrag(const SketchPointPtr& point);
+    bool DragTo(double x, double y);
+    bool EndDrag();
+    bool IsDragging() const;
+    
+    // 元素的几何是否可能随当前拖动而变化（用于只刷新受影响元素的显示）
+    bool IsAffectedByDrag(const SketchElementPtr& element) const;
+    
+    void SetDragIterations(int iterations);
+    int GetDragIterations() const;
+    
     bool ValidateConstraints() const;
     
     void SetTolerance(double tolerance);
@@ -26,14 +51,57 @@ public:
     
     void SetMaxIterations(int maxIterations);
     int GetMaxIterations() const;
+    
+    void SetRunParallel(bool runParallel);
+    bool GetRunParallel() const;
+    
+    // 连通分量个数（约束拓扑变化后重新划分）
+    int GetComponentCount();
+    
+    // 最近一次求解的迭代次数（各分量中的最大值）和残差范数
+    int GetLastIterationCount() const;
+    double GetLastError() const;
 
 private:
     std::vector<ConstraintPtr> m_constraints;
     double m_tolerance;
     int m_maxIterations;
+    bool m_runParallel;
+    int m_dragIterations;
+    int m_lastIterationCount;
+    double m_lastError;
+    
+    // 连通分量：共享任意一个参数来源（点、半径）的约束属于同一分量
+    std::vector<std::vector<ConstraintPtr>> m_components;
+    std::map<const void*, int> m_variableComponent;
+    std::map<const Constraint*, int> m_constraintComponent;
+    bool m_componentsDirty;
+    
+    // 待重新求解的编辑记录，按参数来源/约束保存，分量重新划分后仍然有效
+    std::set<const void*> m_modifiedVariables;
+    std::set<const Constraint*> m_modifiedConstraints;
+    
+    // 拖动会话：方程组结构、符号分解和参数向量在整个拖动过程中复用
+    struct DragSession {
+        SketchPointPtr point;
+        int component;  // -1 表示该点不受任何约束，直接跟随鼠标
+        ConstraintSystem system;
+        SparseLDL solver;
+        std::vector<double> x;
+        double lambda;  // 阻尼系数跨帧保留，但每帧开始时不超过初始值
+        std::set<const void*> variables;
+    };
+    std::unique_ptr<DragSession> m_drag;
     
     double CalculateSystemError() const;
-    bool IterativeSolve();
+    void UpdateComponents();
+    bool SolveComponents(const std::vector<int>& components);
+    bool IterativeSolve(const std::vector<ConstraintPtr>& constraints, int& iterationCount, double& error) const;
+    
+    // LM迭代核心，x 和阻尼系数 lambda 原地更新；返回是否收敛（残差范数小于 tolerance）
+    static bool RunIterations(const ConstraintSystem& system, SparseLDL& solver, std::vector<double>& x,
+                              double& lambda, int maxIterations, double tolerance,
+                              int& iterationCount, double& error);
 };
 
-} // namespace cad_sketch
\ No newline at end of file
+} // namespace cad_sketch
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Constraint.h"
+#include "SketchPoint.h"
+#include "SketchCircle.h"
+#include "SketchArc.h"
+#include <map>
+#include <vector>
+
+namespace cad_sketch {
+
+// 约束方程组：把约束涉及的点坐标和半径收集成一个连续的参数向量，
+// 每个约束展开成一个残差块（1~2个方程，最多涉及8个参数）。
+// 雅可比矩阵按块稀疏存储，J^T J 的稀疏结构在 Build 时一次确定
+class ConstraintSystem {
+public:
+    ConstraintSystem();
+
+    // 收集参数并建立残差块；无效或无法识别的约束被跳过。
+    // dragPoint 非空时追加一个软约束，把该点拉向 SetDragTarget 指定的位置（权重远小于几何约束）
+    void Build(const std::vector<ConstraintPtr>& constraints, const SketchPointPtr& dragPoint = nullptr);
+    
+    // 拖动目标位置，只改残差块的目标值，稀疏结构不变
+    void SetDragTarget(double x, double y);
+    bool HasDragTarget() const { return m_dragBlock >= 0; }
+    
+    int GetParameterCount() const { return static_cast<int>(m_parameters.size()); }
+    int GetResidualCount() const { return m_residualCount; }
+    int GetBlockCount() const { return static_cast<int>(m_blocks.size()); }
+    int GetSkippedCount() const { return m_skippedCount; }
+    
+    // 参数向量与草图元素之间的读写
+    void Gather(std::vector<double>& x) const;
+    void Scatter(const std::vector<double>& x) const;
+    
+    void EvaluateResiduals(const std::vector<double>& x, std::vector<double>& residuals) const;
+    
+    // 雅可比矩阵，按残差行存储：每行的列号就是所属块的参数编号（中心差分求导）
+    void EvaluateJacobian(const std::vector<double>& x, std::vector<double>& jacobian) const;
+    
+    // 组装 J^T J（上三角CSC）和 J^T r
+    void AssembleNormalEquations(const std::vector<double>& jacobian, const std::vector<double>& residuals,
+                                 std::vector<double>& normalValues, std::vector<double>& gradient) const;
+    
+    const std::vector<int>& GetNormalColumnStart() const { return m_normalColumnStart; }
+    const std::vector<int>& GetNormalRowIndex() const { return m_normalRowIndex; }
+    const std::vector<int>& GetNormalDiagonal() const { return m_normalDiagonal; }
+    
+    // 约束的元素组合能否展开成残差块
+    static bool IsSupported(const Constraint& constraint);
+    
+    // 约束涉及的参数来源（点对象、带半径参数的圆/圆弧），用于划分互不耦合的分量
+    static void CollectVariableKeys(const Constraint& constraint, std::vector<const void*>& keys);
+    
+    // 元素自身对应的参数来源，与 CollectVariableKeys 使用相同的键
+    static void CollectElementKeys(const SketchElementPtr& element, std::vector<const void*>& keys);
+    
+    // 单个约束的误差（残差的2范数），约束无法识别时返回0
+    static double EvaluateConstraintError(const Constraint& constraint);
+
+private:
+    enum class ResidualKind {
+        PointsCoincident,   // [x1 y1 x2 y2]
+        PointOnLine,        // [px py ax ay bx by]
+        PointOnCircle,      // [px py cx cy r]
+        Horizontal,         // [x1 y1 x2 y2]
+        Vertical,           // [x1 y1 x2 y2]
+        Parallel,           // [a1x a1y a2x a2y b1x b1y b2x b2y]
+        Perpendicular,      // 同上
+        Angle,              // 同上
+        PointsDistance,     // [x1 y1 x2 y2]
+        PointLineDistance,  // [px py ax ay bx by]
+        Radius,             // [r]
+        Diameter,           // [r]
+        EqualLength,        // [a1x a1y a2x a2y b1x b1y b2x b2y]
+        EqualRadius,        // [r1 r2]
+        DragTarget          // [x] 或 [y]，软约束
+    };
+    
+    static const int MAX_BLOCK_PARAMETERS = 8;
+    
+    struct Block {
+        ResidualKind kind;
+        double value;
+        int parameterCount;
+        int parameters[MAX_BLOCK_PARAMETERS];
+        int residualOffset;
+        int residualCount;
+        int jacobianOffset;  // 该块雅可比在扁平数组中的起点（residualCount * parameterCount 个）
+        int normalOffset;    // 该块在 J^T J 中各参数对的槽位起点
+    };
+    
+    // 参数来源：点的x/y坐标，或圆/圆弧的半径
+    struct ParameterRef {
+        SketchPointPtr point;
+        int axis;  // 0: x, 1: y
+        SketchCirclePtr circle;
+        SketchArcPtr arc;
+    };
+    
+    struct PointHandle { int x; int y; };
+    
+    bool AddBlock(const Constraint& constraint);
+    void PushBlock(ResidualKind kind, double value, const std::vector<int>& parameters);
+    
+    PointHandle PointParameters(const SketchPointPtr& point);
+    bool ElementPoint(const SketchElementPtr& element, PointHandle& handle);
+    bool LineParameters(const SketchElementPtr& element, std::vector<int>& parameters);
+    int RadiusParameter(const SketchElementPtr& element);
+    
+    void ReorderParameters();
+    void BuildNormalStructure();
+    
+    static int ResidualCountOf(ResidualKind kind);
+    static void EvaluateBlock(ResidualKind kind, double value, const double* v, double* residuals);
+    
+    std::vector<ParameterRef> m_parameters;
+    std::map<const SketchPoint*, PointHandle> m_pointIndex;
+    std::map<const SketchElement*, int> m_radiusIndex;
+    
+    std::vector<Block> m_blocks;
+    int m_residualCount;
+    int m_jacobianSize;
+    int m_skippedCount;
+    int m_dragBlock;  // 拖动软约束的第一个块（x），y紧随其后；没有时为-1
+    
+    // J^T J 上三角CSC结构，以及每个块内参数对 (a,b) 对应的槽位
+    std::vector<int> m_normalColumnStart;
+    std::vector<int> m_normalRowIndex;
+    std::vector<int> m_normalDiagonal;
+    std::vector<int> m_normalSlots;
+};
+
+} // namespace cad_sketch
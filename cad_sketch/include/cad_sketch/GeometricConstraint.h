@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Constraint.h"
+
+namespace cad_sketch {
+
+// 通用几何/尺寸约束：约束类型加上元素组合决定方程形式，
+// 误差直接取求解器中对应残差块的值，保证与求解目标一致
+class GeometricConstraint : public Constraint {
+public:
+    GeometricConstraint(ConstraintType type);
+    GeometricConstraint(ConstraintType type, const std::vector<SketchElementPtr>& elements, double value = 0.0);
+    virtual ~GeometricConstraint() = default;
+
+    bool IsValid() const override;
+    std::string GetDescription() const override;
+    double GetError() const override;
+};
+
+using GeometricConstraintPtr = std::shared_ptr<GeometricConstraint>;
+
+} // namespace cad_sketch
@@ -23,6 +23,7 @@
 #include "SketchArc.h"       // 弧元素 - 圆的一部分，但同样精彩
 #include "Constraint.h"      // 约束基类 - 几何关系的守护者
 #include "ConstraintSolver.h" // 约束求解器 - 让几何关系保持和谐的魔法师
+#include "SnapIndex.h"       // 捕捉候选点的网格索引
 #include <vector>            // 动态数组 - 容器界的万金油
 #include <memory>            // 智能指针 - 内存管理的得力助手
 #include <string>            // 字符串 - 人机交流的桥梁
@@ -131,6 +132,55 @@ public:
      */
     bool SolveConstraints();
     
+    /** 
+     * 标记被编辑过的元素 - 拖动或修改了它的几何之后调用
+     * @param element 被修改的元素
+     */
+    void MarkElementModified(const SketchElementPtr& element);
+    
+    /** 
+     * 标记被编辑过的约束 - 比如改了尺寸值之后调用
+     * @param constraint 被修改的约束
+     */
+    void MarkConstraintModified(const ConstraintPtr& constraint);
+    
+    /** 
+     * 增量求解 - 只重新求解被标记内容所在的约束分量，其余分量不动
+     * @return true表示这些分量都求解成功
+     */
+    bool SolveModifiedConstraints();
+    
+    // ========== 拖动求解 - 交互拖点时的快速近似求解 ==========
+    
+    /** 
+     * 开始拖动一个点 - 为该点所在的约束分量建立拖动会话
+     * @param point 被拖动的点
+     * @return true表示会话建立成功
+     */
+    bool BeginPointDrag(const SketchPointPtr& point);
+    
+    /** 
+     * 拖动到新位置 - 每帧调用一次，迭代次数有上限，结果是近似的
+     * @param x 目标位置的草图平面x坐标
+     * @param y 目标位置的草图平面y坐标
+     */
+    bool DragPointTo(double x, double y);
+    
+    /** 
+     * 结束拖动 - 松开鼠标时做一次精确求解
+     * @return true表示约束全部满足
+     */
+    bool EndPointDrag();
+    
+    /** 是否正在拖动 */
+    bool IsDraggingPoint() const;
+    
+    /** 
+     * 元素是否受当前拖动影响 - 只需要刷新这些元素的显示
+     * @param element 要检查的元素
+     */
+    bool IsAffectedByDrag(const SketchElementPtr& element) const;
+    
     /** 
      * 验证约束 - 检查当前的约束系统是否合理
      * @return true表示约束系统没问题，false表示有冲突
@@ -160,6 +210,28 @@ public:
      */
     std::vector<SketchElementPtr> GetSelectedElements() const;
     
+    // ========== 捕捉索引 - 鼠标移动时的最近点查询 ==========
+    
+    /** 
+     * 获取捕捉索引 - 元素增删时已增量更新；求解移动过几何后在这里按需重建
+     * @return 当前草图的捕捉候选点索引
+     */
+    const SnapIndex& GetSnapIndex();
+    
+    /** 
+     * 计算几何哈希 - 只由平面和元素的几何数据决定
+     * 几何相同的草图哈希相同，特征结果缓存以此识别输入是否变化
+     * @return 64位内容哈希
+     */
+    std::size_t ComputeGeometryHash() const;
+    
+    /** 
+     * 几何快照 - 复制平面和全部元素（元素ID不变，共享的点在副本里仍然共享），
+     * 不带约束和选择状态。后台线程读副本，界面线程可以继续编辑原草图
+     * @return 独立的草图副本，几何哈希与原草图相同
+     */
+    std::shared_ptr<Sketch> CloneGeometry() const;
+    
     // ========== 实用工具方法 - 便民小助手 ==========
     
     /** 
@@ -194,6 +266,10 @@ private:
     
     /** 约束求解器 - 负责调解元素关系的"和事佬" */
     ConstraintSolver m_solver;
+    
+    /** 捕捉候选点索引，以及求解后几何是否可能已过期 */
+    SnapIndex m_snapIndex;
+    bool m_snapIndexDirty;
 };
 
 /** 草图智能指针类型别名 - 让内存管理变得轻松愉快 */
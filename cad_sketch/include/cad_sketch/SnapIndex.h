@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SketchElement.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace cad_sketch {
+
+enum class SnapType;
+
+struct SnapCandidate {
+    SnapType type;
+    SketchElementPtr element;
+    double x;
+    double y;
+};
+
+// 捕捉候选点（端点、中点、圆心）的均匀网格索引。
+// 元素增删时增量更新，查询只访问捕捉半径覆盖的网格单元，开销与草图规模无关
+class SnapIndex {
+public:
+    explicit SnapIndex(double cellSize = 10.0);
+
+    // 单元尺寸取捕捉容差的量级最合适；修改后重建索引
+    void SetCellSize(double cellSize);
+    double GetCellSize() const;
+    
+    void AddElement(const SketchElementPtr& element);
+    void RemoveElement(const SketchElementPtr& element);
+    
+    // 元素几何变化后重新登记它的候选点
+    void UpdateElement(const SketchElementPtr& element);
+    
+    void Rebuild(const std::vector<SketchElementPtr>& elements);
+    void Clear();
+    
+    // 半径内距离最近的候选点；accept 为空时接受所有类型
+    bool FindNearest(double x, double y, double radius, SnapCandidate& result,
+                     const std::function<bool(SnapType)>& accept = nullptr) const;
+    
+    int GetCandidateCount() const;
+
+private:
+    double m_cellSize;
+    
+    // 候选点存放在数组中，删除后的空位复用
+    std::vector<SnapCandidate> m_candidates;
+    std::vector<int> m_freeSlots;
+    
+    std::unordered_map<std::uint64_t, std::vector<int>> m_cells;
+    std::unordered_map<const SketchElement*, std::vector<int>> m_elementCandidates;
+    
+    std::int64_t CellCoordinate(double value) const;
+    static std::uint64_t CellKey(std::int64_t ix, std::int64_t iy);
+    
+    void Insert(const SnapCandidate& candidate, std::vector<int>& slots);
+    void CollectCandidates(const SketchElementPtr& element, std::vector<SnapCandidate>& candidates) const;
+};
+
+} // namespace cad_sketch
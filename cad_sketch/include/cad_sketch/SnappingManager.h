@@ -2,6 +2,7 @@
 
 #include "SketchElement.h"
 #include "SketchPoint.h"
+#include "SnapIndex.h"
 #include <vector>
 #include <memory>
 
@@ -45,6 +46,9 @@ public:
     SnapResult FindSnapPoint(const cad_core::Point& inputPoint, 
                            const std::vector<SketchElementPtr>& elements) const;
     
+    // 用空间索引查询：只访问捕捉半径覆盖的网格单元，返回距离最近的候选
+    SnapResult FindSnapPoint(const cad_core::Point& inputPoint, const SnapIndex& index) const;
+    
     SnapResult SnapToGrid(const cad_core::Point& inputPoint) const;
     SnapResult SnapToEndpoints(const cad_core::Point& inputPoint, 
                              const std::vector<SketchElementPtr>& elements) const;
@@ -59,6 +63,9 @@ private:
     std::vector<SnapType> m_enabledSnapTypes;
     
     bool IsWithinTolerance(const cad_core::Point& p1, const cad_core::Point& p2) const;
+    void ConsiderCandidate(const cad_core::Point& inputPoint, const cad_core::Point& candidate,
+                           SnapType type, const SketchElementPtr& element,
+                           SnapResult& result, double& bestDistance) const;
 };
 
 } // namespace cad_sketch
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+namespace cad_sketch {
+
+// 对称正定稀疏矩阵的 LDL^T 分解（上视算法，按消去树求非零结构）。
+// 矩阵以上三角CSC格式给出：第k列只存行号 i <= k 的元素，且必须包含对角元。
+// 符号分解只依赖稀疏结构，结构不变时可以只重复数值分解
+class SparseLDL {
+public:
+    SparseLDL();
+
+    // 符号分解：建立消去树，统计L每列的非零个数
+    bool Analyze(int size, const std::vector<int>& columnStart, const std::vector<int>& rowIndex);
+    
+    // 数值分解，values与Analyze时的rowIndex一一对应；遇到非正主元时返回false
+    bool Factorize(const std::vector<double>& values);
+    
+    // 原地求解 A x = b
+    void Solve(std::vector<double>& rhs) const;
+    
+    int GetSize() const { return m_size; }
+    bool IsAnalyzed() const { return m_analyzed; }
+
+private:
+    int m_size;
+    bool m_analyzed;
+    
+    std::vector<int> m_columnStart;
+    std::vector<int> m_rowIndex;
+    
+    std::vector<int> m_parent;     // 消去树
+    std::vector<int> m_lStart;     // L的列起点
+    std::vector<int> m_lIndex;
+    std::vector<double> m_lValue;
+    std::vector<double> m_diagonal;
+    
+    // 数值分解用的工作区
+    std::vector<int> m_lCount;
+    std::vector<int> m_flag;
+    std::vector<int> m_pattern;
+    std::vector<double> m_work;
+};
+
+} // namespace cad_sketch
@@ -6,7 +6,7 @@ namespace cad_sketch {
 int Constraint::s_nextId = 1;
 
 Constraint::Constraint(ConstraintType type) 
-    : m_type(type), m_id(s_nextId++), m_active(true) {
+    : m_type(type), m_id(s_nextId++), m_active(true), m_value(0.0) {
 }
 
 ConstraintType Constraint::GetType() const {
@@ -37,4 +37,12 @@ void Constraint::SetActive(bool active) {
     m_active = active;
 }
 
+double Constraint::GetValue() const {
+    return m_value;
+}
+
+void Constraint::SetValue(double value) {
+    m_value = value;
+}
+
 } // namespace cad_sketch
\ No newline at end of file
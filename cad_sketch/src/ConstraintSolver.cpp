@@ -1,26 +1,53 @@
 ﻿#include "cad_sketch/ConstraintSolver.h"
+#include "cad_sketch/ConstraintSystem.h"
+#include "cad_sketch/SparseLDL.h"
+#include <OSD_Parallel.hxx>
 #include <cmath>
 #include <algorithm>
+#include <numeric>
 #pragma execution_character_set("utf-8")
 
 namespace cad_sketch {
 
-ConstraintSolver::ConstraintSolver() : m_tolerance(1e-6), m_maxIterations(100) {
+namespace {
+
+const double INITIAL_DAMPING = 1e-3;
+const double MAX_DAMPING = 1e10;
+
+} // namespace
+
+ConstraintSolver::ConstraintSolver() : m_tolerance(1e-6), m_maxIterations(100), m_runParallel(true),
+      m_dragIterations(5), m_lastIterationCount(0), m_lastError(0.0), m_componentsDirty(false) {
 }
 
 void ConstraintSolver::AddConstraint(const ConstraintPtr& constraint) {
     m_constraints.push_back(constraint);
+    m_componentsDirty = true;
+    m_drag.reset();
+    
+    // 新约束需要被满足，下次 SolveModified 时求解它所在的分量
+    m_modifiedConstraints.insert(constraint.get());
 }
 
 void ConstraintSolver::RemoveConstraint(const ConstraintPtr& constraint) {
     auto it = std::find(m_constraints.begin(), m_constraints.end(), constraint);
     if (it != m_constraints.end()) {
         m_constraints.erase(it);
+        m_modifiedConstraints.erase(constraint.get());
+        m_componentsDirty = true;
+        m_drag.reset();
     }
 }
 
 void ConstraintSolver::ClearConstraints() {
     m_constraints.clear();
+    m_components.clear();
+    m_variableComponent.clear();
+    m_constraintComponent.clear();
+    m_modifiedVariables.clear();
+    m_modifiedConstraints.clear();
+    m_componentsDirty = false;
+    m_drag.reset();
 }
 
 const std::vector<ConstraintPtr>& ConstraintSolver::GetConstraints() const {
@@ -28,11 +55,163 @@ const std::vector<ConstraintPtr>& ConstraintSolver::GetConstraints() const {
 }
 
 bool ConstraintSolver::Solve() {
+    m_modifiedVariables.clear();
+    m_modifiedConstraints.clear();
+    m_lastIterationCount = 0;
+    m_lastError = 0.0;
     if (m_constraints.empty()) {
         return true;
     }
     
-    return IterativeSolve();
+    UpdateComponents();
+    std::vector<int> components(m_components.size());
+    std::iota(components.begin(), components.end(), 0);
+    return SolveComponents(components);
+}
+
+void ConstraintSolver::MarkElementModified(const SketchElementPtr& element) {
+    std::vector<const void*> keys;
+    ConstraintSystem::CollectElementKeys(element, keys);
+    m_modifiedVariables.insert(keys.begin(), keys.end());
+}
+
+void ConstraintSolver::MarkConstraintModified(const ConstraintPtr& constraint) {
+    if (constraint) {
+        m_modifiedConstraints.insert(constraint.get());
+    }
+}
+
+bool ConstraintSolver::SolveModified() {
+    m_lastIterationCount = 0;
+    m_lastError = 0.0;
+    UpdateComponents();
+    
+    std::set<int> touched;
+    for (const void* key : m_modifiedVariables) {
+        auto it = m_variableComponent.find(key);
+        if (it != m_variableComponent.end()) {
+            touched.insert(it->second);
+        }
+    }
+    for (const Constraint* constraint : m_modifiedConstraints) {
+        auto it = m_constraintComponent.find(constraint);
+        if (it != m_constraintComponent.end()) {
+            touched.insert(it->second);
+        }
+    }
+    m_modifiedVariables.clear();
+    m_modifiedConstraints.clear();
+    
+    if (touched.empty()) {
+        return true;
+    }
+    return SolveComponents(std::vector<int>(touched.begin(), touched.end()));
+}
+
+bool ConstraintSolver::BeginDrag(const SketchPointPtr& point) {
+    m_drag.reset();
+    if (!point) {
+        return false;
+    }
+    
+    UpdateComponents();
+    auto session = std::make_unique<DragSession>();
+    session->point = point;
+    session->component = -1;
+    session->lambda = INITIAL_DAMPING;
+    
+    auto it = m_variableComponent.find(point.get());
+    if (it == m_variableComponent.end()) {
+        session->variables.insert(point.get());
+        m_drag = std::move(session);
+        return true;
+    }
+    
+    session->component = it->second;
+    const auto& constraints = m_components[session->component];
+    session->system.Build(constraints, point);
+    if (!session->solver.Analyze(session->system.GetParameterCount(),
+                                 session->system.GetNormalColumnStart(),
+                                 session->system.GetNormalRowIndex())) {
+        return false;
+    }
+    session->system.Gather(session->x);
+    
+    std::vector<const void*> keys;
+    for (const auto& constraint : constraints) {
+        ConstraintSystem::CollectVariableKeys(*constraint, keys);
+    }
+    session->variables.insert(keys.begin(), keys.end());
+    
+    m_drag = std::move(session);
+    return true;
+}
+
+bool ConstraintSolver::DragTo(double x, double y) {
+    if (!m_drag) {
+        return false;
+    }
+    
+    if (m_drag->component < 0) {
+        m_drag->point->SetXY(x, y);
+        return true;
+    }
+    
+    // 上一帧留下的小阻尼可以热启动，但大阻尼不带入新的目标位置
+    m_drag->lambda = std::min(m_drag->lambda, INITIAL_DAMPING);
+    
+    // 不要求收敛：迭代次数用完就把当前结果写回，下一帧接着算
+    m_drag->system.SetDragTarget(x, y);
+    bool converged = RunIterations(m_drag->system, m_drag->solver, m_drag->x, m_drag->lambda,
+                                   m_dragIterations, m_tolerance, m_lastIterationCount, m_lastError);
+    if (!converged && m_drag->lambda > MAX_DAMPING) {
+        // 软目标不可达（点被拖离其轨迹）：本帧停在最近处，阻尼从头开始
+        m_drag->lambda = INITIAL_DAMPING;
+    }
+    m_drag->system.Scatter(m_drag->x);
+    return true;
+}
+
+bool ConstraintSolver::EndDrag() {
+    if (!m_drag) {
+        return true;
+    }
+    
+    const int component = m_drag->component;
+    m_drag.reset();
+    if (component < 0) {
+        return true;
+    }
+    
+    // 去掉软约束，从拖动结果出发精确求解
+    return IterativeSolve(m_components[component], m_lastIterationCount, m_lastError);
+}
+
+bool ConstraintSolver::IsDragging() const {
+    return m_drag != nullptr;
+}
+
+bool ConstraintSolver::IsAffectedByDrag(const SketchElementPtr& element) const {
+    if (!m_drag) {
+        return false;
+    }
+    
+    std::vector<const void*> keys;
+    ConstraintSystem::CollectElementKeys(element, keys);
+    for (const void* key : keys) {
+        if (m_drag->variables.count(key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ConstraintSolver::SetDragIterations(int iterations) {
+    m_dragIterations = std::max(1, iterations);
+}
+
+int ConstraintSolver::GetDragIterations() const {
+    return m_dragIterations;
 }
 
 bool ConstraintSolver::ValidateConstraints() const {
@@ -60,6 +239,27 @@ int ConstraintSolver::GetMaxIterations() const {
     return m_maxIterations;
 }
 
+void ConstraintSolver::SetRunParallel(bool runParallel) {
+    m_runParallel = runParallel;
+}
+
+bool ConstraintSolver::GetRunParallel() const {
+    return m_runParallel;
+}
+
+int ConstraintSolver::GetComponentCount() {
+    UpdateComponents();
+    return static_cast<int>(m_components.size());
+}
+
+int ConstraintSolver::GetLastIterationCount() const {
+    return m_lastIterationCount;
+}
+
+double ConstraintSolver::GetLastError() const {
+    return m_lastError;
+}
+
 double ConstraintSolver::CalculateSystemError() const {
     double totalError = 0.0;
     
@@ -73,23 +273,183 @@ double ConstraintSolver::CalculateSystemError() const {
     return std::sqrt(totalError);
 }
 
-bool ConstraintSolver::IterativeSolve() {
-    for (int iteration = 0; iteration < m_maxIterations; ++iteration) {
-        double error = CalculateSystemError();
+void ConstraintSolver::UpdateComponents() {
+    if (!m_componentsDirty) {
+        return;
+    }
+    m_componentsDirty = false;
+    
+    // 并查集：约束之间只要共享一个参数来源就合并
+    const int count = static_cast<int>(m_constraints.size());
+    std::vector<int> parent(count);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    
+    std::map<const void*, int> firstOwner;
+    std::vector<const void*> keys;
+    for (int i = 0; i < count; ++i) {
+        keys.clear();
+        ConstraintSystem::CollectVariableKeys(*m_constraints[i], keys);
+        for (const void* key : keys) {
+            auto inserted = firstOwner.emplace(key, i);
+            if (!inserted.second) {
+                int a = find(i);
+                int b = find(inserted.first->second);
+                if (a != b) {
+                    parent[std::max(a, b)] = std::min(a, b);
+                }
+            }
+        }
+    }
+    
+    // 分量按其第一条约束的顺序编号，划分结果与约束添加顺序一致
+    m_components.clear();
+    m_constraintComponent.clear();
+    m_variableComponent.clear();
+    std::map<int, int> rootComponent;
+    for (int i = 0; i < count; ++i) {
+        int root = find(i);
+        auto it = rootComponent.find(root);
+        if (it == rootComponent.end()) {
+            it = rootComponent.emplace(root, static_cast<int>(m_components.size())).first;
+            m_components.emplace_back();
+        }
+        m_components[it->second].push_back(m_constraints[i]);
+        m_constraintComponent[m_constraints[i].get()] = it->second;
+    }
+    for (const auto& pair : firstOwner) {
+        m_variableComponent[pair.first] = m_constraintComponent[m_constraints[pair.second].get()];
+    }
+}
+
+bool ConstraintSolver::SolveComponents(const std::vector<int>& components) {
+    // 各分量的参数互不相交，可以同时写回；结果按下标保存，归约顺序固定
+    const int count = static_cast<int>(components.size());
+    std::vector<char> solved(count, 0);
+    std::vector<int> iterations(count, 0);
+    std::vector<double> errors(count, 0.0);
+    
+    OSD_Parallel::For(0, count, [&](const Standard_Integer index) {
+        solved[index] = IterativeSolve(m_components[components[index]], iterations[index], errors[index]) ? 1 : 0;
+    }, !m_runParallel || count < 2);
+    
+    bool allSolved = true;
+    double squaredError = 0.0;
+    for (int index = 0; index < count; ++index) {
+        allSolved = allSolved && solved[index];
+        m_lastIterationCount = std::max(m_lastIterationCount, iterations[index]);
+        squaredError += errors[index] * errors[index];
+    }
+    m_lastError = std::sqrt(squaredError);
+    return allSolved;
+}
+
+bool ConstraintSolver::IterativeSolve(const std::vector<ConstraintPtr>& constraints,
+                                      int& iterationCount, double& error) const {
+    iterationCount = 0;
+    error = 0.0;
+    
+    ConstraintSystem system;
+    system.Build(constraints);
+    if (system.GetResidualCount() == 0) {
+        return true;
+    }
+    
+    // J^T J 的稀疏结构在整个求解过程中不变，符号分解只做一次
+    SparseLDL solver;
+    if (!solver.Analyze(system.GetParameterCount(), system.GetNormalColumnStart(), system.GetNormalRowIndex())) {
+        return false;
+    }
+    
+    std::vector<double> x;
+    system.Gather(x);
+    double lambda = INITIAL_DAMPING;
+    if (!RunIterations(system, solver, x, lambda, m_maxIterations, m_tolerance, iterationCount, error)) {
+        return false;
+    }
+    
+    // 只在收敛时写回，失败时草图保持原状
+    system.Scatter(x);
+    return true;
+}
+
+bool ConstraintSolver::RunIterations(const ConstraintSystem& system, SparseLDL& solver, std::vector<double>& x,
+                                     double& lambda, int maxIterations, double tolerance,
+                                     int& iterationCount, double& error) {
+    const int n = system.GetParameterCount();
+    const std::vector<int>& diagonal = system.GetNormalDiagonal();
+    
+    std::vector<double> trial, residuals, trialResiduals, jacobian, normal, damped, gradient, step;
+    system.EvaluateResiduals(x, residuals);
+    
+    auto squaredNorm = [](const std::vector<double>& v) {
+        double sum = 0.0;
+        for (double value : v) {
+            sum += value * value;
+        }
+        return sum;
+    };
+    
+    // Levenberg-Marquardt：(J^T J + λ·diag(J^T J)) δ = -J^T r
+    double cost = squaredNorm(residuals);
+    bool converged = std::sqrt(cost) < tolerance;
+    iterationCount = 0;
+    
+    for (int iteration = 0; iteration < maxIterations && !converged; ++iteration) {
+        iterationCount = iteration + 1;
         
-        if (error < m_tolerance) {
-            return true;
+        system.EvaluateJacobian(x, jacobian);
+        system.AssembleNormalEquations(jacobian, residuals, normal, gradient);
+        
+        while (true) {
+            damped = normal;
+            for (int k = 0; k < n; ++k) {
+                // 加一个小下限，欠约束（奇异）时仍然正定
+                damped[diagonal[k]] += lambda * (normal[diagonal[k]] + 1e-6);
+            }
+            
+            if (solver.Factorize(damped)) {
+                step.resize(n);
+                for (int k = 0; k < n; ++k) {
+                    step[k] = -gradient[k];
+                }
+                solver.Solve(step);
+                
+                trial.resize(n);
+                for (int k = 0; k < n; ++k) {
+                    trial[k] = x[k] + step[k];
+                }
+                system.EvaluateResiduals(trial, trialResiduals);
+                
+                double trialCost = squaredNorm(trialResiduals);
+                if (trialCost < cost) {
+                    x.swap(trial);
+                    residuals.swap(trialResiduals);
+                    cost = trialCost;
+                    lambda = std::max(lambda / 3.0, 1e-12);
+                    break;
+                }
+            }
+            
+            lambda *= 4.0;
+            if (lambda > MAX_DAMPING) {
+                // 无法再下降：约束矛盾或陷入局部极小
+                error = std::sqrt(cost);
+                return false;
+            }
         }
         
-        // Placeholder for actual constraint solving algorithm
-        // In a real implementation, this would use methods like:
-        // - Newton-Raphson iteration
-        // - Levenberg-Marquardt algorithm
-        // - Gauss-Newton method
-        // For now, we'll just return true for compilation
+        converged = std::sqrt(cost) < tolerance;
     }
     
-    return false;
+    error = std::sqrt(cost);
+    return converged;
 }
 
 } // namespace cad_sketch
\ No newline at end of file
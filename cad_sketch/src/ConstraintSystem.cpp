@@ -0,0 +1,684 @@
+﻿#include "cad_sketch/ConstraintSystem.h"
+#include "cad_sketch/SketchLine.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#pragma execution_character_set("utf-8")
+
+namespace cad_sketch {
+
+namespace {
+
+const double LENGTH_EPSILON = 1e-12;
+
+// 拖动软约束的权重：拖动时几何约束仍然占主导，目标点只在剩余自由度上起作用
+const double DRAG_WEIGHT = 1e-2;
+
+bool IsPoint(const SketchElementPtr& element) {
+    return element && element->GetType() == SketchElementType::Point;
+}
+
+bool IsLine(const SketchElementPtr& element) {
+    return element && element->GetType() == SketchElementType::Line;
+}
+
+bool IsCurve(const SketchElementPtr& element) {
+    return element && (element->GetType() == SketchElementType::Circle ||
+                       element->GetType() == SketchElementType::Arc);
+}
+
+// 点元素或圆/圆弧的圆心
+bool IsPointLike(const SketchElementPtr& element) {
+    return IsPoint(element) || IsCurve(element);
+}
+
+double WrapAngle(double angle) {
+    while (angle > M_PI) angle -= 2.0 * M_PI;
+    while (angle <= -M_PI) angle += 2.0 * M_PI;
+    return angle;
+}
+
+} // namespace
+
+ConstraintSystem::ConstraintSystem()
+    : m_residualCount(0), m_jacobianSize(0), m_skippedCount(0), m_dragBlock(-1) {
+}
+
+void ConstraintSystem::Build(const std::vector<ConstraintPtr>& constraints, const SketchPointPtr& dragPoint) {
+    m_parameters.clear();
+    m_pointIndex.clear();
+    m_radiusIndex.clear();
+    m_blocks.clear();
+    m_residualCount = 0;
+    m_jacobianSize = 0;
+    m_skippedCount = 0;
+    m_dragBlock = -1;
+    
+    for (const auto& constraint : constraints) {
+        if (!constraint || !constraint->IsActive()) {
+            continue;
+        }
+        if (!AddBlock(*constraint)) {
+            m_skippedCount++;
+        }
+    }
+    
+    if (dragPoint) {
+        PointHandle handle = PointParameters(dragPoint);
+        m_dragBlock = static_cast<int>(m_blocks.size());
+        PushBlock(ResidualKind::DragTarget, dragPoint->GetX(), {handle.x});
+        PushBlock(ResidualKind::DragTarget, dragPoint->GetY(), {handle.y});
+    }
+    
+    ReorderParameters();
+    BuildNormalStructure();
+}
+
+bool ConstraintSystem::AddBlock(const Constraint& constraint) {
+    const auto& elements = constraint.GetElements();
+    const double value = constraint.GetValue();
+    std::vector<int> parameters;
+    
+    // 先只检查元素类型，确认能识别后再分配参数，避免留下不属于任何块的参数
+    switch (constraint.GetType()) {
+        case ConstraintType::Coincident: {
+            if (elements.size() != 2) return false;
+            const auto& a = elements[0];
+            const auto& b = elements[1];
+            
+            if ((IsPoint(a) && IsPoint(b)) || (IsCurve(a) && IsCurve(b))) {
+                // 两点重合；两个圆/圆弧则为同心
+                PointHandle pa, pb;
+                if (!ElementPoint(a, pa)) return false;
+                if (!ElementPoint(b, pb)) return false;
+                PushBlock(ResidualKind::PointsCoincident, 0.0, {pa.x, pa.y, pb.x, pb.y});
+                return true;
+            }
+            
+            const auto& point = IsPoint(a) ? a : b;
+            const auto& other = IsPoint(a) ? b : a;
+            if (!IsPoint(point)) return false;
+            
+            if (IsLine(other)) {
+                PointHandle p;
+                if (!ElementPoint(point, p)) return false;
+                parameters = {p.x, p.y};
+                if (!LineParameters(other, parameters)) return false;
+                PushBlock(ResidualKind::PointOnLine, 0.0, parameters);
+                return true;
+            }
+            if (IsCurve(other)) {
+                PointHandle p, c;
+                if (!ElementPoint(point, p)) return false;
+                if (!ElementPoint(other, c)) return false;
+                PushBlock(ResidualKind::PointOnCircle, 0.0, {p.x, p.y, c.x, c.y, RadiusParameter(other)});
+                return true;
+            }
+            return false;
+        }
+        
+        case ConstraintType::Horizontal:
+        case ConstraintType::Vertical: {
+            ResidualKind kind = constraint.GetType() == ConstraintType::Horizontal
+                ? ResidualKind::Horizontal : ResidualKind::Vertical;
+            if (elements.size() == 1 && IsLine(elements[0])) {
+                if (!LineParameters(elements[0], parameters)) return false;
+                PushBlock(kind, 0.0, parameters);
+                return true;
+            }
+            if (elements.size() == 2 && IsPointLike(elements[0]) && IsPointLike(elements[1])) {
+                PointHandle pa, pb;
+                if (!ElementPoint(elements[0], pa)) return false;
+                if (!ElementPoint(elements[1], pb)) return false;
+                PushBlock(kind, 0.0, {pa.x, pa.y, pb.x, pb.y});
+                return true;
+            }
+            return false;
+        }
+        
+        case ConstraintType::Parallel:
+        case ConstraintType::Perpendicular:
+        case ConstraintType::Angle: {
+            if (elements.size() != 2 || !IsLine(elements[0]) || !IsLine(elements[1])) return false;
+            if (!LineParameters(elements[0], parameters)) return false;
+            if (!LineParameters(elements[1], parameters)) return false;
+            ResidualKind kind = constraint.GetType() == ConstraintType::Parallel ? ResidualKind::Parallel
+                : constraint.GetType() == ConstraintType::Perpendicular ? ResidualKind::Perpendicular
+                : ResidualKind::Angle;
+            PushBlock(kind, value, parameters);
+            return true;
+        }
+        
+        case ConstraintType::Distance: {
+            if (elements.size() == 1 && IsLine(elements[0])) {
+                // 线段长度
+                if (!LineParameters(elements[0], parameters)) return false;
+                PushBlock(ResidualKind::PointsDistance, value, parameters);
+                return true;
+            }
+            if (elements.size() != 2) return false;
+            const auto& a = elements[0];
+            const auto& b = elements[1];
+            
+            if (IsPointLike(a) && IsPointLike(b)) {
+                PointHandle pa, pb;
+                if (!ElementPoint(a, pa)) return false;
+                if (!ElementPoint(b, pb)) return false;
+                PushBlock(ResidualKind::PointsDistance, value, {pa.x, pa.y, pb.x, pb.y});
+                return true;
+            }
+            
+            const auto& point = IsLine(a) ? b : a;
+            const auto& line = IsLine(a) ? a : b;
+            if (!IsPointLike(point) || !IsLine(line)) return false;
+            PointHandle p;
+            if (!ElementPoint(point, p)) return false;
+            parameters = {p.x, p.y};
+            if (!LineParameters(line, parameters)) return false;
+            PushBlock(ResidualKind::PointLineDistance, value, parameters);
+            return true;
+        }
+        
+        case ConstraintType::Radius:
+        case ConstraintType::Diameter: {
+            if (elements.size() != 1 || !IsCurve(elements[0])) return false;
+            ResidualKind kind = constraint.GetType() == ConstraintType::Radius
+                ? ResidualKind::Radius : ResidualKind::Diameter;
+            PushBlock(kind, value, {RadiusParameter(elements[0])});
+            return true;
+        }
+        
+        case ConstraintType::Equal: {
+            if (elements.size() != 2) return false;
+            if (IsLine(elements[0]) && IsLine(elements[1])) {
+                if (!LineParameters(elements[0], parameters)) return false;
+                if (!LineParameters(elements[1], parameters)) return false;
+                PushBlock(ResidualKind::EqualLength, 0.0, parameters);
+                return true;
+            }
+            if (IsCurve(elements[0]) && IsCurve(elements[1])) {
+                PushBlock(ResidualKind::EqualRadius, 0.0,
+                          {RadiusParameter(elements[0]), RadiusParameter(elements[1])});
+                return true;
+            }
+            return false;
+        }
+    }
+    
+    return false;
+}
+
+void ConstraintSystem::SetDragTarget(double x, double y) {
+    if (m_dragBlock < 0) {
+        return;
+    }
+    m_blocks[m_dragBlock].value = x;
+    m_blocks[m_dragBlock + 1].value = y;
+}
+
+void ConstraintSystem::PushBlock(ResidualKind kind, double value, const std::vector<int>& parameters) {
+    Block block;
+    block.kind = kind;
+    block.value = value;
+    block.parameterCount = static_cast<int>(parameters.size());
+    std::copy(parameters.begin(), parameters.end(), block.parameters);
+    block.residualOffset = m_residualCount;
+    block.residualCount = ResidualCountOf(kind);
+    block.jacobianOffset = m_jacobianSize;
+    block.normalOffset = 0;
+    
+    m_residualCount += block.residualCount;
+    m_jacobianSize += block.residualCount * block.parameterCount;
+    m_blocks.push_back(block);
+}
+
+ConstraintSystem::PointHandle ConstraintSystem::PointParameters(const SketchPointPtr& point) {
+    // 多个元素共享同一个点对象时只对应一组参数
+    auto it = m_pointIndex.find(point.get());
+    if (it != m_pointIndex.end()) {
+        return it->second;
+    }
+    
+    PointHandle handle;
+    handle.x = static_cast<int>(m_parameters.size());
+    m_parameters.push_back(ParameterRef{point, 0, nullptr, nullptr});
+    handle.y = static_cast<int>(m_parameters.size());
+    m_parameters.push_back(ParameterRef{point, 1, nullptr, nullptr});
+    
+    m_pointIndex[point.get()] = handle;
+    return handle;
+}
+
+bool ConstraintSystem::ElementPoint(const SketchElementPtr& element, PointHandle& handle) {
+    SketchPointPtr point;
+    switch (element->GetType()) {
+        case SketchElementType::Point:
+            point = std::static_pointer_cast<SketchPoint>(element);
+            break;
+        case SketchElementType::Circle:
+            point = std::static_pointer_cast<SketchCircle>(element)->GetCenter();
+            break;
+        case SketchElementType::Arc:
+            point = std::static_pointer_cast<SketchArc>(element)->GetCenter();
+            break;
+        default:
+            return false;
+    }
+    if (!point) {
+        return false;
+    }
+    
+    handle = PointParameters(point);
+    return true;
+}
+
+bool ConstraintSystem::LineParameters(const SketchElementPtr& element, std::vector<int>& parameters) {
+    auto line = std::static_pointer_cast<SketchLine>(element);
+    if (!line->GetStartPoint() || !line->GetEndPoint()) {
+        return false;
+    }
+    
+    PointHandle start = PointParameters(line->GetStartPoint());
+    PointHandle end = PointParameters(line->GetEndPoint());
+    parameters.insert(parameters.end(), {start.x, start.y, end.x, end.y});
+    return true;
+}
+
+int ConstraintSystem::RadiusParameter(const SketchElementPtr& element) {
+    auto it = m_radiusIndex.find(element.get());
+    if (it != m_radiusIndex.end()) {
+        return it->second;
+    }
+    
+    int index = static_cast<int>(m_parameters.size());
+    if (element->GetType() == SketchElementType::Circle) {
+        m_parameters.push_back(ParameterRef{nullptr, 0, std::static_pointer_cast<SketchCircle>(element), nullptr});
+    } else {
+        m_parameters.push_back(ParameterRef{nullptr, 0, nullptr, std::static_pointer_cast<SketchArc>(element)});
+    }
+    m_radiusIndex[element.get()] = index;
+    return index;
+}
+
+void ConstraintSystem::ReorderParameters() {
+    const int n = GetParameterCount();
+    if (n == 0) {
+        return;
+    }
+    
+    // 参数邻接关系：同属一个块的参数相邻
+    std::vector<std::vector<int>> adjacency(n);
+    for (const Block& block : m_blocks) {
+        for (int a = 0; a < block.parameterCount; ++a) {
+            for (int b = 0; b < block.parameterCount; ++b) {
+                if (block.parameters[a] != block.parameters[b]) {
+                    adjacency[block.parameters[a]].push_back(block.parameters[b]);
+                }
+            }
+        }
+    }
+    for (auto& neighbours : adjacency) {
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+    
+    // 反向Cuthill-McKee排序：减小带宽，从而减少LDL分解的填充
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<char> visited(n, 0);
+    std::vector<int> byDegree(n);
+    for (int i = 0; i < n; ++i) byDegree[i] = i;
+    std::stable_sort(byDegree.begin(), byDegree.end(), [&adjacency](int a, int b) {
+        return adjacency[a].size() < adjacency[b].size();
+    });
+    
+    for (int start : byDegree) {
+        if (visited[start]) {
+            continue;
+        }
+        std::deque<int> queue;
+        queue.push_back(start);
+        visited[start] = 1;
+        while (!queue.empty()) {
+            int current = queue.front();
+            queue.pop_front();
+            order.push_back(current);
+            
+            std::vector<int> next;
+            for (int neighbour : adjacency[current]) {
+                if (!visited[neighbour]) {
+                    visited[neighbour] = 1;
+                    next.push_back(neighbour);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(), [&adjacency](int a, int b) {
+                return adjacency[a].size() < adjacency[b].size();
+            });
+            queue.insert(queue.end(), next.begin(), next.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    
+    std::vector<int> newIndex(n);
+    std::vector<ParameterRef> reordered(n);
+    for (int i = 0; i < n; ++i) {
+        newIndex[order[i]] = i;
+        reordered[i] = m_parameters[order[i]];
+    }
+    m_parameters.swap(reordered);
+    
+    for (Block& block : m_blocks) {
+        for (int j = 0; j < block.parameterCount; ++j) {
+            block.parameters[j] = newIndex[block.parameters[j]];
+        }
+    }
+    for (auto& pair : m_pointIndex) {
+        pair.second.x = newIndex[pair.second.x];
+        pair.second.y = newIndex[pair.second.y];
+    }
+    for (auto& pair : m_radiusIndex) {
+        pair.second = newIndex[pair.second];
+    }
+}
+
+void ConstraintSystem::BuildNormalStructure() {
+    const int n = GetParameterCount();
+    
+    // 每列的行号（只取上三角），对角元总是存在，保证阻尼后矩阵正定
+    std::vector<std::vector<int>> columns(n);
+    for (int k = 0; k < n; ++k) {
+        columns[k].push_back(k);
+    }
+    for (const Block& block : m_blocks) {
+        for (int a = 0; a < block.parameterCount; ++a) {
+            for (int b = a; b < block.parameterCount; ++b) {
+                int i = std::min(block.parameters[a], block.parameters[b]);
+                int k = std::max(block.parameters[a], block.parameters[b]);
+                columns[k].push_back(i);
+            }
+        }
+    }
+    
+    m_normalColumnStart.assign(n + 1, 0);
+    m_normalRowIndex.clear();
+    m_normalDiagonal.assign(n, 0);
+    for (int k = 0; k < n; ++k) {
+        auto& rows = columns[k];
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        
+        m_normalColumnStart[k] = static_cast<int>(m_normalRowIndex.size());
+        m_normalRowIndex.insert(m_normalRowIndex.end(), rows.begin(), rows.end());
+        m_normalDiagonal[k] = static_cast<int>(m_normalRowIndex.size()) - 1;  // 行号升序，对角元在末尾
+    }
+    m_normalColumnStart[n] = static_cast<int>(m_normalRowIndex.size());
+    
+    // 块内每个参数对 (a <= b) 在CSC中的位置
+    m_normalSlots.clear();
+    for (Block& block : m_blocks) {
+        block.normalOffset = static_cast<int>(m_normalSlots.size());
+        for (int a = 0; a < block.parameterCount; ++a) {
+            for (int b = a; b < block.parameterCount; ++b) {
+                int i = std::min(block.parameters[a], block.parameters[b]);
+                int k = std::max(block.parameters[a], block.parameters[b]);
+                auto begin = m_normalRowIndex.begin() + m_normalColumnStart[k];
+                auto end = m_normalRowIndex.begin() + m_normalColumnStart[k + 1];
+                m_normalSlots.push_back(static_cast<int>(std::lower_bound(begin, end, i) - m_normalRowIndex.begin()));
+            }
+        }
+    }
+}
+
+void ConstraintSystem::Gather(std::vector<double>& x) const {
+    x.resize(m_parameters.size());
+    for (size_t i = 0; i < m_parameters.size(); ++i) {
+        const ParameterRef& ref = m_parameters[i];
+        if (ref.point) {
+            x[i] = ref.axis == 0 ? ref.point->GetX() : ref.point->GetY();
+        } else if (ref.circle) {
+            x[i] = ref.circle->GetRadius();
+        } else {
+            x[i] = ref.arc->GetRadius();
+        }
+    }
+}
+
+void ConstraintSystem::Scatter(const std::vector<double>& x) const {
+    for (size_t i = 0; i < m_parameters.size(); ++i) {
+        const ParameterRef& ref = m_parameters[i];
+        if (ref.point) {
+            if (ref.axis == 0) {
+                ref.point->SetX(x[i]);
+            } else {
+                ref.point->SetY(x[i]);
+            }
+        } else if (ref.circle) {
+            ref.circle->SetRadius(x[i]);
+        } else {
+            ref.arc->SetRadius(x[i]);
+        }
+    }
+}
+
+void ConstraintSystem::EvaluateResiduals(const std::vector<double>& x, std::vector<double>& residuals) const {
+    residuals.resize(m_residualCount);
+    double local[MAX_BLOCK_PARAMETERS];
+    
+    for (const Block& block : m_blocks) {
+        for (int j = 0; j < block.parameterCount; ++j) {
+            local[j] = x[block.parameters[j]];
+        }
+        EvaluateBlock(block.kind, block.value, local, &residuals[block.residualOffset]);
+    }
+}
+
+void ConstraintSystem::EvaluateJacobian(const std::vector<double>& x, std::vector<double>& jacobian) const {
+    jacobian.resize(m_jacobianSize);
+    double local[MAX_BLOCK_PARAMETERS];
+    double plus[2], minus[2];
+    
+    // 每个块只有几个参数，局部中心差分即可，不需要扰动整个参数向量
+    for (const Block& block : m_blocks) {
+        for (int j = 0; j < block.parameterCount; ++j) {
+            local[j] = x[block.parameters[j]];
+        }
+        
+        for (int j = 0; j < block.parameterCount; ++j) {
+            const double original = local[j];
+            const double step = 1e-7 * std::max(1.0, std::abs(original));
+            
+            local[j] = original + step;
+            EvaluateBlock(block.kind, block.value, local, plus);
+            local[j] = original - step;
+            EvaluateBlock(block.kind, block.value, local, minus);
+            local[j] = original;
+            
+            for (int q = 0; q < block.residualCount; ++q) {
+                jacobian[block.jacobianOffset + q * block.parameterCount + j] = (plus[q] - minus[q]) / (2.0 * step);
+            }
+        }
+    }
+}
+
+void ConstraintSystem::AssembleNormalEquations(const std::vector<double>& jacobian, const std::vector<double>& residuals,
+                                               std::vector<double>& normalValues, std::vector<double>& gradient) const {
+    normalValues.assign(m_normalRowIndex.size(), 0.0);
+    gradient.assign(m_parameters.size(), 0.0);
+    
+    for (const Block& block : m_blocks) {
+        const int n = block.parameterCount;
+        const double* J = &jacobian[block.jacobianOffset];
+        const double* r = &residuals[block.residualOffset];
+        
+        for (int q = 0; q < block.residualCount; ++q) {
+            for (int j = 0; j < n; ++j) {
+                gradient[block.parameters[j]] += J[q * n + j] * r[q];
+            }
+        }
+        
+        int slot = block.normalOffset;
+        for (int a = 0; a < n; ++a) {
+            for (int b = a; b < n; ++b) {
+                double sum = 0.0;
+                for (int q = 0; q < block.residualCount; ++q) {
+                    sum += J[q * n + a] * J[q * n + b];
+                }
+                // 同一个参数在块内出现两次时，交叉项落在对角元上，要计两次
+                if (a != b && block.parameters[a] == block.parameters[b]) {
+                    sum *= 2.0;
+                }
+                normalValues[m_normalSlots[slot++]] += sum;
+            }
+        }
+    }
+}
+
+bool ConstraintSystem::IsSupported(const Constraint& constraint) {
+    ConstraintSystem system;
+    return system.AddBlock(constraint);
+}
+
+void ConstraintSystem::CollectVariableKeys(const Constraint& constraint, std::vector<const void*>& keys) {
+    ConstraintSystem system;
+    if (!system.AddBlock(constraint)) {
+        return;
+    }
+    
+    for (const auto& pair : system.m_pointIndex) {
+        keys.push_back(pair.first);
+    }
+    for (const auto& pair : system.m_radiusIndex) {
+        keys.push_back(pair.first);
+    }
+}
+
+void ConstraintSystem::CollectElementKeys(const SketchElementPtr& element, std::vector<const void*>& keys) {
+    if (!element) {
+        return;
+    }
+    
+    switch (element->GetType()) {
+        case SketchElementType::Point:
+            keys.push_back(static_cast<const SketchPoint*>(element.get()));
+            break;
+        case SketchElementType::Line: {
+            auto line = std::static_pointer_cast<SketchLine>(element);
+            keys.push_back(line->GetStartPoint().get());
+            keys.push_back(line->GetEndPoint().get());
+            break;
+        }
+        case SketchElementType::Circle:
+            keys.push_back(std::static_pointer_cast<SketchCircle>(element)->GetCenter().get());
+            keys.push_back(element.get());
+            break;
+        case SketchElementType::Arc:
+            keys.push_back(std::static_pointer_cast<SketchArc>(element)->GetCenter().get());
+            keys.push_back(element.get());
+            break;
+    }
+}
+
+double ConstraintSystem::EvaluateConstraintError(const Constraint& constraint) {
+    ConstraintSystem system;
+    if (!system.AddBlock(constraint)) {
+        return 0.0;
+    }
+    
+    std::vector<double> x, residuals;
+    system.Gather(x);
+    system.EvaluateResiduals(x, residuals);
+    
+    double sum = 0.0;
+    for (double r : residuals) {
+        sum += r * r;
+    }
+    return std::sqrt(sum);
+}
+
+int ConstraintSystem::ResidualCountOf(ResidualKind kind) {
+    return kind == ResidualKind::PointsCoincident ? 2 : 1;
+}
+
+void ConstraintSystem::EvaluateBlock(ResidualKind kind, double value, const double* v, double* residuals) {
+    switch (kind) {
+        case ResidualKind::PointsCoincident:
+            residuals[0] = v[2] - v[0];
+            residuals[1] = v[3] - v[1];
+            break;
+            
+        case ResidualKind::PointOnLine:
+        case ResidualKind::PointLineDistance: {
+            // 点到直线的有向距离
+            double dx = v[4] - v[2];
+            double dy = v[5] - v[3];
+            double length = std::hypot(dx, dy);
+            double distance = length < LENGTH_EPSILON
+                ? std::hypot(v[0] - v[2], v[1] - v[3])
+                : (dx * (v[1] - v[3]) - dy * (v[0] - v[2])) / length;
+            if (kind == ResidualKind::PointOnLine || value == 0.0) {
+                residuals[0] = distance;
+            } else {
+                residuals[0] = std::abs(distance) - value;
+            }
+            break;
+        }
+        
+        case ResidualKind::PointOnCircle:
+            residuals[0] = std::hypot(v[0] - v[2], v[1] - v[3]) - v[4];
+            break;
+            
+        case ResidualKind::Horizontal:
+            residuals[0] = v[3] - v[1];
+            break;
+            
+        case ResidualKind::Vertical:
+            residuals[0] = v[2] - v[0];
+            break;
+            
+        case ResidualKind::Parallel:
+        case ResidualKind::Perpendicular:
+        case ResidualKind::Angle: {
+            double ax = v[2] - v[0], ay = v[3] - v[1];
+            double bx = v[6] - v[4], by = v[7] - v[5];
+            double cross = ax * by - ay * bx;
+            double dot = ax * bx + ay * by;
+            double scale = std::max(std::hypot(ax, ay) * std::hypot(bx, by), LENGTH_EPSILON);
+            
+            // 用归一化的正弦/余弦，残差与线段长度无关
+            if (kind == ResidualKind::Parallel) {
+                residuals[0] = cross / scale;
+            } else if (kind == ResidualKind::Perpendicular) {
+                residuals[0] = dot / scale;
+            } else {
+                residuals[0] = WrapAngle(std::atan2(cross, dot) - value);
+            }
+            break;
+        }
+        
+        case ResidualKind::PointsDistance:
+            residuals[0] = std::hypot(v[2] - v[0], v[3] - v[1]) - value;
+            break;
+            
+        case ResidualKind::Radius:
+            residuals[0] = v[0] - value;
+            break;
+            
+        case ResidualKind::Diameter:
+            residuals[0] = 2.0 * v[0] - value;
+            break;
+            
+        case ResidualKind::EqualLength:
+            residuals[0] = std::hypot(v[2] - v[0], v[3] - v[1]) - std::hypot(v[6] - v[4], v[7] - v[5]);
+            break;
+            
+        case ResidualKind::EqualRadius:
+            residuals[0] = v[0] - v[1];
+            break;
+            
+        case ResidualKind::DragTarget:
+            residuals[0] = DRAG_WEIGHT * (v[0] - value);
+            break;
+    }
+}
+
+} // namespace cad_sketch
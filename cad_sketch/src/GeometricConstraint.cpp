@@ -0,0 +1,43 @@
+﻿#include "cad_sketch/GeometricConstraint.h"
+#include "cad_sketch/ConstraintSystem.h"
+#include <cmath>
+#include <sstream>
+#pragma execution_character_set("utf-8")
+
+namespace cad_sketch {
+
+GeometricConstraint::GeometricConstraint(ConstraintType type) : Constraint(type) {
+}
+
+GeometricConstraint::GeometricConstraint(ConstraintType type, const std::vector<SketchElementPtr>& elements, double value)
+    : Constraint(type) {
+    m_elements = elements;
+    m_value = value;
+}
+
+bool GeometricConstraint::IsValid() const {
+    return ConstraintSystem::IsSupported(*this);
+}
+
+std::string GeometricConstraint::GetDescription() const {
+    std::ostringstream oss;
+    switch (m_type) {
+        case ConstraintType::Horizontal: oss << "Horizontal"; break;
+        case ConstraintType::Vertical: oss << "Vertical"; break;
+        case ConstraintType::Parallel: oss << "Parallel"; break;
+        case ConstraintType::Perpendicular: oss << "Perpendicular"; break;
+        case ConstraintType::Coincident: oss << "Coincident"; break;
+        case ConstraintType::Distance: oss << "Distance (" << m_value << ")"; break;
+        case ConstraintType::Angle: oss << "Angle (" << m_value * 180.0 / M_PI << "°)"; break;
+        case ConstraintType::Radius: oss << "Radius (" << m_value << ")"; break;
+        case ConstraintType::Diameter: oss << "Diameter (" << m_value << ")"; break;
+        case ConstraintType::Equal: oss << "Equal"; break;
+    }
+    return oss.str();
+}
+
+double GeometricConstraint::GetError() const {
+    return ConstraintSystem::EvaluateConstraintError(*this);
+}
+
+} // namespace cad_sketch
@@ -1,13 +1,32 @@
 ﻿#include "cad_sketch/Sketch.h"
 #include <algorithm>
+#include <functional>
+#include <map>
 #pragma execution_character_set("utf-8")
 
 namespace cad_sketch {
 
-Sketch::Sketch() : m_name("Sketch"), m_plane(gp::XOY()) { 
+namespace {
+
+void HashCombine(std::size_t& seed, std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+void HashValue(std::size_t& seed, double value) {
+    HashCombine(seed, std::hash<double>()(value));
+}
+
+void HashPoint(std::size_t& seed, const SketchPointPtr& point) {
+    HashValue(seed, point->GetX());
+    HashValue(seed, point->GetY());
 }
 
-Sketch::Sketch(const std::string& name) : m_name(name), m_plane(gp::XOY()) { 
+} // anonymous namespace
+
+Sketch::Sketch() : m_name("Sketch"), m_plane(gp::XOY()), m_snapIndexDirty(false) { 
+}
+
+Sketch::Sketch(const std::string& name) : m_name(name), m_plane(gp::XOY()), m_snapIndexDirty(false) { 
 }
 
 void Sketch::SetPlane(const gp_Pln& plane) {
@@ -28,17 +47,21 @@ void Sketch::SetName(const std::string& name) {
 
 void Sketch::AddElement(const SketchElementPtr& element) {
     m_elements.push_back(element);
+    m_snapIndex.AddElement(element);
 }
 
 void Sketch::RemoveElement(const SketchElementPtr& element) {
     auto it = std::find(m_elements.begin(), m_elements.end(), element);
     if (it != m_elements.end()) {
         m_elements.erase(it);
+        m_snapIndex.RemoveElement(element);
     }
 }
 
 void Sketch::ClearElements() {
     m_elements.clear();
+    m_snapIndex.Clear();
+    m_snapIndexDirty = false;
 }
 
 const std::vector<SketchElementPtr>& Sketch::GetElements() const {
@@ -77,9 +100,46 @@ const std::vector<ConstraintPtr>& Sketch::GetConstraints() const {
 }
 
 bool Sketch::SolveConstraints() {
+    m_snapIndexDirty = true;
     return m_solver.Solve();
 }
 
+void Sketch::MarkElementModified(const SketchElementPtr& element) {
+    m_solver.MarkElementModified(element);
+    m_snapIndex.UpdateElement(element);
+}
+
+void Sketch::MarkConstraintModified(const ConstraintPtr& constraint) {
+    m_solver.MarkConstraintModified(constraint);
+}
+
+bool Sketch::SolveModifiedConstraints() {
+    m_snapIndexDirty = true;
+    return m_solver.SolveModified();
+}
+
+bool Sketch::BeginPointDrag(const SketchPointPtr& point) {
+    return m_solver.BeginDrag(point);
+}
+
+bool Sketch::DragPointTo(double x, double y) {
+    m_snapIndexDirty = true;
+    return m_solver.DragTo(x, y);
+}
+
+bool Sketch::EndPointDrag() {
+    m_snapIndexDirty = true;
+    return m_solver.EndDrag();
+}
+
+bool Sketch::IsDraggingPoint() const {
+    return m_solver.IsDragging();
+}
+
+bool Sketch::IsAffectedByDrag(const SketchElementPtr& element) const {
+    return m_solver.IsAffectedByDrag(element);
+}
+
 bool Sketch::ValidateConstraints() const {
     return m_solver.ValidateConstraints();
 }
@@ -108,6 +168,111 @@ std::vector<SketchElementPtr> Sketch::GetSelectedElements() const {
     return selected;
 }
 
+const SnapIndex& Sketch::GetSnapIndex() {
+    // 求解器可能移动任意点，几何变化后整体重建一次，之后的鼠标移动都直接查询
+    if (m_snapIndexDirty) {
+        m_snapIndex.Rebuild(m_elements);
+        m_snapIndexDirty = false;
+    }
+    return m_snapIndex;
+}
+
+std::shared_ptr<Sketch> Sketch::CloneGeometry() const {
+    auto clone = std::make_shared<Sketch>(m_name);
+    clone->m_plane = m_plane;
+    
+    // 线段端点等可能被多个元素共享，副本里保持同样的共享关系
+    std::map<const SketchPoint*, SketchPointPtr> points;
+    auto copyPoint = [&points](const SketchPointPtr& point) -> SketchPointPtr {
+        if (!point) {
+            return nullptr;
+        }
+        SketchPointPtr& copy = points[point.get()];
+        if (!copy) {
+            copy = std::make_shared<SketchPoint>(point->GetPoint());
+            copy->SetId(point->GetId());
+        }
+        return copy;
+    };
+    
+    for (const auto& element : m_elements) {
+        SketchElementPtr copy;
+        switch (element->GetType()) {
+            case SketchElementType::Point:
+                copy = copyPoint(std::static_pointer_cast<SketchPoint>(element));
+                break;
+            case SketchElementType::Line: {
+                auto line = std::static_pointer_cast<SketchLine>(element);
+                copy = std::make_shared<SketchLine>(copyPoint(line->GetStartPoint()), copyPoint(line->GetEndPoint()));
+                break;
+            }
+            case SketchElementType::Circle: {
+                auto circle = std::static_pointer_cast<SketchCircle>(element);
+                copy = std::make_shared<SketchCircle>(copyPoint(circle->GetCenter()), circle->GetRadius());
+                break;
+            }
+            case SketchElementType::Arc: {
+                auto arc = std::static_pointer_cast<SketchArc>(element);
+                copy = std::make_shared<SketchArc>(copyPoint(arc->GetCenter()), arc->GetRadius(),
+                                                   arc->GetStartAngle(), arc->GetEndAngle());
+                break;
+            }
+        }
+        copy->SetId(element->GetId());
+        copy->SetVisible(element->IsVisible());
+        clone->AddElement(copy);
+    }
+    return clone;
+}
+
+std::size_t Sketch::ComputeGeometryHash() const {
+    std::size_t seed = 0;
+    
+    const gp_Ax3& position = m_plane.Position();
+    const gp_Dir& xDirection = position.XDirection();
+    const gp_Dir& direction = position.Direction();
+    HashValue(seed, position.Location().X());
+    HashValue(seed, position.Location().Y());
+    HashValue(seed, position.Location().Z());
+    HashValue(seed, xDirection.X());
+    HashValue(seed, xDirection.Y());
+    HashValue(seed, xDirection.Z());
+    HashValue(seed, direction.X());
+    HashValue(seed, direction.Y());
+    HashValue(seed, direction.Z());
+    
+    // 元素顺序会影响线框的拼接，因此按顺序参与哈希
+    for (const auto& element : m_elements) {
+        HashCombine(seed, static_cast<std::size_t>(element->GetType()));
+        switch (element->GetType()) {
+            case SketchElementType::Point:
+                HashPoint(seed, std::static_pointer_cast<SketchPoint>(element));
+                break;
+            case SketchElementType::Line: {
+                auto line = std::static_pointer_cast<SketchLine>(element);
+                HashPoint(seed, line->GetStartPoint());
+                HashPoint(seed, line->GetEndPoint());
+                break;
+            }
+            case SketchElementType::Circle: {
+                auto circle = std::static_pointer_cast<SketchCircle>(element);
+                HashPoint(seed, circle->GetCenter());
+                HashValue(seed, circle->GetRadius());
+                break;
+            }
+            case SketchElementType::Arc: {
+                auto arc = std::static_pointer_cast<SketchArc>(element);
+                HashPoint(seed, arc->GetCenter());
+                HashValue(seed, arc->GetRadius());
+                HashValue(seed, arc->GetStartAngle());
+                HashValue(seed, arc->GetEndAngle());
+                break;
+            }
+        }
+    }
+    return seed;
+}
+
 bool Sketch::IsEmpty() const {
     return m_elements.empty();
 }
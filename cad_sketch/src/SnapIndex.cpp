@@ -0,0 +1,205 @@
+﻿#include "cad_sketch/SnapIndex.h"
+#include "cad_sketch/SnappingManager.h"
+#include "cad_sketch/SketchLine.h"
+#include "cad_sketch/SketchCircle.h"
+#include "cad_sketch/SketchArc.h"
+#include <algorithm>
+#include <cmath>
+#pragma execution_character_set("utf-8")
+
+namespace cad_sketch {
+
+SnapIndex::SnapIndex(double cellSize) : m_cellSize(cellSize > 0.0 ? cellSize : 10.0) {
+}
+
+void SnapIndex::SetCellSize(double cellSize) {
+    if (cellSize <= 0.0 || cellSize == m_cellSize) {
+        return;
+    }
+    m_cellSize = cellSize;
+    
+    // 按新的单元尺寸重新分桶，候选点本身不变
+    m_cells.clear();
+    for (int i = 0; i < static_cast<int>(m_candidates.size()); ++i) {
+        if (m_candidates[i].element) {
+            const SnapCandidate& candidate = m_candidates[i];
+            m_cells[CellKey(CellCoordinate(candidate.x), CellCoordinate(candidate.y))].push_back(i);
+        }
+    }
+}
+
+double SnapIndex::GetCellSize() const {
+    return m_cellSize;
+}
+
+void SnapIndex::AddElement(const SketchElementPtr& element) {
+    if (!element || m_elementCandidates.count(element.get())) {
+        return;
+    }
+    
+    std::vector<SnapCandidate> candidates;
+    CollectCandidates(element, candidates);
+    
+    std::vector<int>& slots = m_elementCandidates[element.get()];
+    for (const SnapCandidate& candidate : candidates) {
+        Insert(candidate, slots);
+    }
+}
+
+void SnapIndex::RemoveElement(const SketchElementPtr& element) {
+    if (!element) {
+        return;
+    }
+    auto it = m_elementCandidates.find(element.get());
+    if (it == m_elementCandidates.end()) {
+        return;
+    }
+    
+    for (int slot : it->second) {
+        SnapCandidate& candidate = m_candidates[slot];
+        auto cell = m_cells.find(CellKey(CellCoordinate(candidate.x), CellCoordinate(candidate.y)));
+        if (cell != m_cells.end()) {
+            auto& slots = cell->second;
+            slots.erase(std::remove(slots.begin(), slots.end(), slot), slots.end());
+            if (slots.empty()) {
+                m_cells.erase(cell);
+            }
+        }
+        candidate.element.reset();
+        m_freeSlots.push_back(slot);
+    }
+    m_elementCandidates.erase(it);
+}
+
+void SnapIndex::UpdateElement(const SketchElementPtr& element) {
+    RemoveElement(element);
+    AddElement(element);
+}
+
+void SnapIndex::Rebuild(const std::vector<SketchElementPtr>& elements) {
+    Clear();
+    for (const auto& element : elements) {
+        AddElement(element);
+    }
+}
+
+void SnapIndex::Clear() {
+    m_candidates.clear();
+    m_freeSlots.clear();
+    m_cells.clear();
+    m_elementCandidates.clear();
+}
+
+bool SnapIndex::FindNearest(double x, double y, double radius, SnapCandidate& result,
+                            const std::function<bool(SnapType)>& accept) const {
+    bool found = false;
+    double bestDistance = radius;
+    
+    auto visit = [&](const std::vector<int>& slots) {
+        for (int slot : slots) {
+            const SnapCandidate& candidate = m_candidates[slot];
+            if (accept && !accept(candidate.type)) {
+                continue;
+            }
+            double distance = std::hypot(candidate.x - x, candidate.y - y);
+            if (distance <= bestDistance) {
+                bestDistance = distance;
+                result = candidate;
+                found = true;
+            }
+        }
+    };
+    
+    const std::int64_t minX = CellCoordinate(x - radius);
+    const std::int64_t maxX = CellCoordinate(x + radius);
+    const std::int64_t minY = CellCoordinate(y - radius);
+    const std::int64_t maxY = CellCoordinate(y + radius);
+    
+    // 半径远大于单元时，直接遍历非空单元更省
+    const double coveredCells = static_cast<double>(maxX - minX + 1) * static_cast<double>(maxY - minY + 1);
+    if (coveredCells > static_cast<double>(m_cells.size())) {
+        for (const auto& cell : m_cells) {
+            visit(cell.second);
+        }
+        return found;
+    }
+    
+    for (std::int64_t ix = minX; ix <= maxX; ++ix) {
+        for (std::int64_t iy = minY; iy <= maxY; ++iy) {
+            auto cell = m_cells.find(CellKey(ix, iy));
+            if (cell != m_cells.end()) {
+                visit(cell->second);
+            }
+        }
+    }
+    return found;
+}
+
+int SnapIndex::GetCandidateCount() const {
+    return static_cast<int>(m_candidates.size() - m_freeSlots.size());
+}
+
+std::int64_t SnapIndex::CellCoordinate(double value) const {
+    return static_cast<std::int64_t>(std::floor(value / m_cellSize));
+}
+
+std::uint64_t SnapIndex::CellKey(std::int64_t ix, std::int64_t iy) {
+    return (static_cast<std::uint64_t>(ix) << 32) ^ (static_cast<std::uint64_t>(iy) & 0xffffffffULL);
+}
+
+void SnapIndex::Insert(const SnapCandidate& candidate, std::vector<int>& slots) {
+    int slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_candidates[slot] = candidate;
+    } else {
+        slot = static_cast<int>(m_candidates.size());
+        m_candidates.push_back(candidate);
+    }
+    
+    m_cells[CellKey(CellCoordinate(candidate.x), CellCoordinate(candidate.y))].push_back(slot);
+    slots.push_back(slot);
+}
+
+void SnapIndex::CollectCandidates(const SketchElementPtr& element, std::vector<SnapCandidate>& candidates) const {
+    switch (element->GetType()) {
+        case SketchElementType::Line: {
+            auto line = std::static_pointer_cast<SketchLine>(element);
+            const auto& start = line->GetStartPoint();
+            const auto& end = line->GetEndPoint();
+            if (!start || !end) {
+                break;
+            }
+            candidates.push_back({SnapType::Endpoint, element, start->GetX(), start->GetY()});
+            candidates.push_back({SnapType::Endpoint, element, end->GetX(), end->GetY()});
+            candidates.push_back({SnapType::Midpoint, element,
+                                  (start->GetX() + end->GetX()) / 2.0, (start->GetY() + end->GetY()) / 2.0});
+            break;
+        }
+        case SketchElementType::Circle: {
+            const auto& center = std::static_pointer_cast<SketchCircle>(element)->GetCenter();
+            if (center) {
+                candidates.push_back({SnapType::Center, element, center->GetX(), center->GetY()});
+            }
+            break;
+        }
+        case SketchElementType::Arc: {
+            auto arc = std::static_pointer_cast<SketchArc>(element);
+            if (!arc->GetCenter()) {
+                break;
+            }
+            candidates.push_back({SnapType::Center, element, arc->GetCenter()->GetX(), arc->GetCenter()->GetY()});
+            
+            auto start = arc->GetStartPoint();
+            auto end = arc->GetEndPoint();
+            candidates.push_back({SnapType::Endpoint, element, start->GetX(), start->GetY()});
+            candidates.push_back({SnapType::Endpoint, element, end->GetX(), end->GetY()});
+            break;
+        }
+        case SketchElementType::Point:
+            break;
+    }
+}
+
+} // namespace cad_sketch
@@ -105,6 +105,31 @@ SnapResult SnappingManager::FindSnapPoint(const cad_core::Point& inputPoint,
     return bestResult;
 }
 
+SnapResult SnappingManager::FindSnapPoint(const cad_core::Point& inputPoint, const SnapIndex& index) const {
+    SnapResult bestResult;
+    double bestDistance = m_snapTolerance;
+    
+    if (IsSnapTypeEnabled(SnapType::Grid)) {
+        SnapResult gridResult = SnapToGrid(inputPoint);
+        if (gridResult.found) {
+            bestResult = gridResult;
+            bestDistance = inputPoint.Distance(gridResult.snapPoint);
+        }
+    }
+    
+    // 端点、中点、圆心在一次最近邻查询中一起比较
+    SnapCandidate candidate;
+    auto accept = [this](SnapType type) { return IsSnapTypeEnabled(type); };
+    if (index.FindNearest(inputPoint.X(), inputPoint.Y(), bestDistance, candidate, accept)) {
+        bestResult.found = true;
+        bestResult.type = candidate.type;
+        bestResult.snapPoint = cad_core::Point(candidate.x, candidate.y, 0);
+        bestResult.element = candidate.element;
+    }
+    
+    return bestResult;
+}
+
 SnapResult SnappingManager::SnapToGrid(const cad_core::Point& inputPoint) const {
     SnapResult result;
     
@@ -125,25 +150,21 @@ SnapResult SnappingManager::SnapToGrid(const cad_core::Point& inputPoint) const
 SnapResult SnappingManager::SnapToEndpoints(const cad_core::Point& inputPoint, 
                                           const std::vector<SketchElementPtr>& elements) const {
     SnapResult result;
+    double bestDistance = m_snapTolerance;
     
     for (const auto& element : elements) {
         if (element->GetType() == SketchElementType::Line) {
-            auto line = std::dynamic_pointer_cast<SketchLine>(element);
-            if (line && line->GetStartPoint() && line->GetEndPoint()) {
-                if (IsWithinTolerance(inputPoint, line->GetStartPoint()->GetPoint())) {
-                    result.found = true;
-                    result.type = SnapType::Endpoint;
-                    result.snapPoint = line->GetStartPoint()->GetPoint();
-                    result.element = element;
-                    return result;
-                }
-                if (IsWithinTolerance(inputPoint, line->GetEndPoint()->GetPoint())) {
-                    result.found = true;
-                    result.type = SnapType::Endpoint;
-                    result.snapPoint = line->GetEndPoint()->GetPoint();
-                    result.element = element;
-                    return result;
-                }
+            auto line = std::static_pointer_cast<SketchLine>(element);
+            if (line->GetStartPoint() && line->GetEndPoint()) {
+                ConsiderCandidate(inputPoint, line->GetStartPoint()->GetPoint(), SnapType::Endpoint, element, result, bestDistance);
+                ConsiderCandidate(inputPoint, line->GetEndPoint()->GetPoint(), SnapType::Endpoint, element, result, bestDistance);
+            }
+        } else if (element->GetType() == SketchElementType::Arc) {
+            // 与 SnapIndex 的候选点一致：圆弧的起点和终点也是端点
+            auto arc = std::static_pointer_cast<SketchArc>(element);
+            if (arc->GetCenter()) {
+                ConsiderCandidate(inputPoint, arc->GetStartPoint()->GetPoint(), SnapType::Endpoint, element, result, bestDistance);
+                ConsiderCandidate(inputPoint, arc->GetEndPoint()->GetPoint(), SnapType::Endpoint, element, result, bestDistance);
             }
         }
     }
@@ -154,22 +175,15 @@ SnapResult SnappingManager::SnapToEndpoints(const cad_core::Point& inputPoint,
 SnapResult SnappingManager::SnapToMidpoints(const cad_core::Point& inputPoint, 
                                           const std::vector<SketchElementPtr>& elements) const {
     SnapResult result;
+    double bestDistance = m_snapTolerance;
     
     for (const auto& element : elements) {
         if (element->GetType() == SketchElementType::Line) {
-            auto line = std::dynamic_pointer_cast<SketchLine>(element);
-            if (line && line->GetStartPoint() && line->GetEndPoint()) {
+            auto line = std::static_pointer_cast<SketchLine>(element);
+            if (line->GetStartPoint() && line->GetEndPoint()) {
                 double midX = (line->GetStartPoint()->GetX() + line->GetEndPoint()->GetX()) / 2.0;
                 double midY = (line->GetStartPoint()->GetY() + line->GetEndPoint()->GetY()) / 2.0;
-                cad_core::Point midPoint(midX, midY, 0);
-                
-                if (IsWithinTolerance(inputPoint, midPoint)) {
-                    result.found = true;
-                    result.type = SnapType::Midpoint;
-                    result.snapPoint = midPoint;
-                    result.element = element;
-                    return result;
-                }
+                ConsiderCandidate(inputPoint, cad_core::Point(midX, midY, 0), SnapType::Midpoint, element, result, bestDistance);
             }
         }
     }
@@ -180,36 +194,37 @@ SnapResult SnappingManager::SnapToMidpoints(const cad_core::Point& inputPoint,
 SnapResult SnappingManager::SnapToCenters(const cad_core::Point& inputPoint, 
                                         const std::vector<SketchElementPtr>& elements) const {
     SnapResult result;
+    double bestDistance = m_snapTolerance;
     
     for (const auto& element : elements) {
+        SketchPointPtr center;
         if (element->GetType() == SketchElementType::Circle) {
-            auto circle = std::dynamic_pointer_cast<SketchCircle>(element);
-            if (circle && circle->GetCenter()) {
-                if (IsWithinTolerance(inputPoint, circle->GetCenter()->GetPoint())) {
-                    result.found = true;
-                    result.type = SnapType::Center;
-                    result.snapPoint = circle->GetCenter()->GetPoint();
-                    result.element = element;
-                    return result;
-                }
-            }
+            center = std::static_pointer_cast<SketchCircle>(element)->GetCenter();
         } else if (element->GetType() == SketchElementType::Arc) {
-            auto arc = std::dynamic_pointer_cast<SketchArc>(element);
-            if (arc && arc->GetCenter()) {
-                if (IsWithinTolerance(inputPoint, arc->GetCenter()->GetPoint())) {
-                    result.found = true;
-                    result.type = SnapType::Center;
-                    result.snapPoint = arc->GetCenter()->GetPoint();
-                    result.element = element;
-                    return result;
-                }
-            }
+            center = std::static_pointer_cast<SketchArc>(element)->GetCenter();
+        }
+        if (center) {
+            ConsiderCandidate(inputPoint, center->GetPoint(), SnapType::Center, element, result, bestDistance);
         }
     }
     
     return result;
 }
 
+// 保留距离最近的候选，而不是第一个落在容差内的
+void SnappingManager::ConsiderCandidate(const cad_core::Point& inputPoint, const cad_core::Point& candidate,
+                                        SnapType type, const SketchElementPtr& element,
+                                        SnapResult& result, double& bestDistance) const {
+    double distance = inputPoint.Distance(candidate);
+    if (distance <= bestDistance) {
+        bestDistance = distance;
+        result.found = true;
+        result.type = type;
+        result.snapPoint = candidate;
+        result.element = element;
+    }
+}
+
 bool SnappingManager::IsWithinTolerance(const cad_core::Point& p1, const cad_core::Point& p2) const {
     return p1.Distance(p2) <= m_snapTolerance;
 }
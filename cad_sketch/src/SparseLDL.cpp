@@ -0,0 +1,139 @@
+﻿#include "cad_sketch/SparseLDL.h"
+#include <algorithm>
+#pragma execution_character_set("utf-8")
+
+namespace cad_sketch {
+
+SparseLDL::SparseLDL() : m_size(0), m_analyzed(false) {
+}
+
+bool SparseLDL::Analyze(int size, const std::vector<int>& columnStart, const std::vector<int>& rowIndex) {
+    m_analyzed = false;
+    if (size < 0 || static_cast<int>(columnStart.size()) != size + 1) {
+        return false;
+    }
+    
+    m_size = size;
+    m_columnStart = columnStart;
+    m_rowIndex = rowIndex;
+    
+    m_parent.assign(size, -1);
+    m_lCount.assign(size, 0);
+    m_flag.assign(size, -1);
+    
+    // 沿消去树从每个非零元向上走，直到遇到本列已标记的节点
+    for (int k = 0; k < size; ++k) {
+        m_flag[k] = k;
+        for (int p = columnStart[k]; p < columnStart[k + 1]; ++p) {
+            int i = rowIndex[p];
+            if (i >= k) {
+                continue;
+            }
+            for (; m_flag[i] != k; i = m_parent[i]) {
+                if (m_parent[i] == -1) {
+                    m_parent[i] = k;
+                }
+                m_lCount[i]++;
+                m_flag[i] = k;
+            }
+        }
+    }
+    
+    m_lStart.assign(size + 1, 0);
+    for (int k = 0; k < size; ++k) {
+        m_lStart[k + 1] = m_lStart[k] + m_lCount[k];
+    }
+    
+    m_lIndex.assign(m_lStart[size], 0);
+    m_lValue.assign(m_lStart[size], 0.0);
+    m_diagonal.assign(size, 0.0);
+    m_pattern.assign(size, 0);
+    m_work.assign(size, 0.0);
+    
+    m_analyzed = true;
+    return true;
+}
+
+bool SparseLDL::Factorize(const std::vector<double>& values) {
+    if (!m_analyzed || values.size() != m_rowIndex.size()) {
+        return false;
+    }
+    
+    const int n = m_size;
+    std::fill(m_flag.begin(), m_flag.end(), -1);
+    for (int k = 0; k < n; ++k) {
+        // 第k行的非零结构 = A(0:k,k) 各元素在消去树上到k的路径
+        m_work[k] = 0.0;
+        int top = n;
+        m_flag[k] = k;
+        m_lCount[k] = 0;
+        
+        for (int p = m_columnStart[k]; p < m_columnStart[k + 1]; ++p) {
+            int i = m_rowIndex[p];
+            if (i > k) {
+                continue;
+            }
+            m_work[i] += values[p];
+            
+            int length = 0;
+            for (; m_flag[i] != k; i = m_parent[i]) {
+                m_pattern[length++] = i;
+                m_flag[i] = k;
+            }
+            while (length > 0) {
+                m_pattern[--top] = m_pattern[--length];
+            }
+        }
+        
+        // 稀疏三角求解得到L的第k行和D(k)
+        m_diagonal[k] = m_work[k];
+        m_work[k] = 0.0;
+        for (; top < n; ++top) {
+            int i = m_pattern[top];
+            double yi = m_work[i];
+            m_work[i] = 0.0;
+            
+            int end = m_lStart[i] + m_lCount[i];
+            for (int p = m_lStart[i]; p < end; ++p) {
+                m_work[m_lIndex[p]] -= m_lValue[p] * yi;
+            }
+            
+            double lki = yi / m_diagonal[i];
+            m_diagonal[k] -= lki * yi;
+            m_lIndex[end] = k;
+            m_lValue[end] = lki;
+            m_lCount[i]++;
+        }
+        
+        if (!(m_diagonal[k] > 0.0)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void SparseLDL::Solve(std::vector<double>& rhs) const {
+    const int n = m_size;
+    
+    // L y = b
+    for (int j = 0; j < n; ++j) {
+        for (int p = m_lStart[j]; p < m_lStart[j + 1]; ++p) {
+            rhs[m_lIndex[p]] -= m_lValue[p] * rhs[j];
+        }
+    }
+    
+    // D z = y
+    for (int j = 0; j < n; ++j) {
+        rhs[j] /= m_diagonal[j];
+    }
+    
+    // L^T x = z
+    for (int j = n - 1; j >= 0; --j) {
+        for (int p = m_lStart[j]; p < m_lStart[j + 1]; ++p) {
+            rhs[j] -= m_lValue[p] * rhs[m_lIndex[p]];
+        }
+    }
+}
+
+} // namespace cad_sketch
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <V3d_View.hxx>
+
+namespace cad_ui {
+
+// 帧统计信息（毫秒）
+struct FrameStats {
+    unsigned long long frameCount = 0;          // 已渲染的帧数
+    unsigned long long immediateFrameCount = 0; // 其中只重绘立即层的帧数
+    unsigned long long requestCount = 0;        // 收到的重绘请求数
+    unsigned long long coalescedCount = 0;      // 被合并掉（未单独渲染）的请求数
+    double lastFrameMs = 0.0;
+    double averageFrameMs = 0.0;                // 最近若干帧的滑动平均
+    double maxFrameMs = 0.0;
+};
+
+// 按需渲染调度器：各处只标记"脏"，同一刷新周期内的请求合并成一次渲染。
+// 完整重绘（场景变化、相机变化）和立即层重绘（动态高亮、预览）分开，
+// 只有立即层脏时调用 RedrawImmediate，不重绘整个场景
+class FrameScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FrameScheduler(QObject* parent = nullptr);
+    ~FrameScheduler() = default;
+
+    void SetView(const Handle(V3d_View)& view);
+    
+    // 请求重绘，在下一帧统一执行
+    void RequestRedraw();
+    void RequestImmediateRedraw();
+    
+    // 立即渲染所有待处理的请求（例如 paintEvent 中）
+    void RenderNow();
+    
+    // 帧间隔，默认按屏幕刷新率
+    void SetFrameInterval(int milliseconds);
+    int GetFrameInterval() const { return m_frameIntervalMs; }
+    
+    bool HasPendingFrame() const { return m_fullRedrawPending || m_immediateRedrawPending; }
+    
+    const FrameStats& GetFrameStats() const { return m_stats; }
+    void ResetFrameStats();
+
+signals:
+    void FrameRendered(double frameMs);
+
+private slots:
+    void OnFrameTimer();
+
+private:
+    void ScheduleFrame();
+    void RecordFrame(double frameMs, bool immediateOnly);
+
+    Handle(V3d_View) m_view;
+    QTimer* m_frameTimer;
+    QElapsedTimer m_sinceLastFrame;
+    
+    int m_frameIntervalMs;
+    bool m_fullRedrawPending;
+    bool m_immediateRedrawPending;
+    
+    FrameStats m_stats;
+    
+    static const int DEFAULT_FRAME_INTERVAL_MS = 16;
+    static const int FRAME_TIME_WINDOW = 120;
+};
+
+} // namespace cad_ui
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <AIS_Shape.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS_Shape.hxx>
+
+namespace cad_ui {
+
+// 实例化显示对象：共享同一个TopoDS_TShape、只有TopLoc_Location不同的形状
+// （阵列、复制）连接到同一个原型显示对象，显卡上只有一份网格，
+// 每个实例只带自己的变换。原型不直接显示。
+// 选择仍按实例计算，拾取到的子形状需用 ToInstanceSpace 转回模型坐标
+class InstancedShape : public AIS_Shape {
+    DEFINE_STANDARD_RTTIEXT(InstancedShape, AIS_Shape)
+
+public:
+    InstancedShape(const TopoDS_Shape& instanceShape, const Handle(AIS_Shape)& prototype);
+    
+    const Handle(AIS_Shape)& GetPrototype() const { return m_prototype; }
+    const TopLoc_Location& GetInstanceLocation() const { return m_instanceLocation; }
+    
+    // 原型坐标下的子形状 -> 该实例在模型坐标下的子形状
+    TopoDS_Shape ToInstanceSpace(const TopoDS_Shape& prototypeSubShape) const;
+
+protected:
+    void Compute(const Handle(PrsMgr_PresentationManager)& presentationManager,
+                 const Handle(Prs3d_Presentation)& presentation,
+                 const Standard_Integer mode) override;
+
+private:
+    Handle(AIS_Shape) m_prototype;
+    TopLoc_Location m_instanceLocation;
+};
+
+DEFINE_STANDARD_HANDLE(InstancedShape, AIS_Shape)
+
+} // namespace cad_ui
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <AIS_Shape.hxx>
+#include <TopoDS_Shape.hxx>
+
+namespace cad_ui {
+
+// 多细节层次（LOD）形状显示对象。
+// 显示用的网格可以来自原形状的副本（按不同弦高单独划分网格），
+// 而选择仍然基于原形状，因此子形状拾取和高亮不受LOD切换影响
+class LodShape : public AIS_Shape {
+    DEFINE_STANDARD_RTTIEXT(LodShape, AIS_Shape)
+
+public:
+    // 0: 粗糙，1: 默认（原形状自己的网格），2: 精细
+    static const int LEVEL_COUNT = 3;
+    static const int DEFAULT_LEVEL = 1;
+
+    LodShape(const TopoDS_Shape& shape, double baseDeflection);
+
+    // 各层次的弦高：以默认弦高为基准，每级相差 LEVEL_RATIO 倍
+    double GetLevelDeflection(int level) const;
+    double GetBaseDeflection() const { return m_baseDeflection; }
+    
+    // 设置某一层次已划分好网格的形状副本
+    void SetLevelShape(int level, const TopoDS_Shape& meshedShape);
+    bool HasLevel(int level) const;
+    
+    // 切换显示层次；返回是否需要重新显示
+    bool SetActiveLevel(int level);
+    int GetActiveLevel() const { return m_activeLevel; }
+    
+    // 期望层次（可能还在后台划分网格）
+    void SetRequestedLevel(int level) { m_requestedLevel = level; }
+    int GetRequestedLevel() const { return m_requestedLevel; }
+
+protected:
+    void Compute(const Handle(PrsMgr_PresentationManager)& presentationManager,
+                 const Handle(Prs3d_Presentation)& presentation,
+                 const Standard_Integer mode) override;
+
+private:
+    double m_baseDeflection;
+    TopoDS_Shape m_levelShapes[LEVEL_COUNT];
+    int m_activeLevel;
+    int m_requestedLevel;
+    
+    static constexpr double LEVEL_RATIO = 4.0;
+};
+
+DEFINE_STANDARD_HANDLE(LodShape, AIS_Shape)
+
+} // namespace cad_ui
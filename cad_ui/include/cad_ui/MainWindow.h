@@ -233,8 +233,7 @@ private:
     QString m_currentFileName;
     bool m_documentModified;
     
-    // Transform preview support
-    std::vector<cad_core::ShapePtr> m_previewShapes;
+    // Transform preview support (presentations are transformed in place by the viewer)
     bool m_previewActive;
     
     // Sketch mode support
@@ -253,6 +252,8 @@ private:
     void UpdateWindowTitle();
     void UpdateActions();
     void RefreshUIFromOCAF();  // Refresh UI from OCAF document state
+    void ApplyOCAFChanges(const cad_core::ShapeChanges& changes);  // Incremental refresh after undo/redo
+    cad_core::ShapePtr ExecuteFeatureForDocument(const cad_feature::FeaturePtr& feature);  // Own topology per document object
     
     bool SaveChanges();
     void SetDocumentModified(bool modified);
@@ -8,6 +8,8 @@
 #include <QDoubleSpinBox>
 #include <QGroupBox>
 #include <QScrollArea>
+#include <QTimer>
+#include <future>
 #include "cad_core/Shape.h"
 #include "cad_feature/Feature.h"
 
@@ -24,6 +26,9 @@ public:
     void SetFeature(const cad_feature::FeaturePtr& feature);
     void Clear();
 
+private slots:
+    void OnPropertiesPollTimer();
+
 private:
     QVBoxLayout* m_mainLayout;
     QScrollArea* m_scrollArea;
@@ -33,7 +38,15 @@ private:
     cad_core::ShapePtr m_currentShape;
     cad_feature::FeaturePtr m_currentFeature;
     
+    // 后台计算的形状属性，算好前显示"Computing..."
+    std::shared_future<cad_core::Shape::PropertiesPtr> m_pendingProperties;
+    QTimer* m_propertiesTimer;
+    bool m_shownEstimate = false;
+    bool m_propertiesFailed = false;
+    static const int PROPERTIES_POLL_MS = 50;
+    
     void CreateShapeProperties();
+    void AddShapeProperties(const cad_core::ShapeProperties& properties);
     void CreateFeatureProperties();
     void ClearProperties();
     
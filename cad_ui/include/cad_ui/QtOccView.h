@@ -8,6 +8,8 @@
 #include <QTimer>
 #include <map>
 #include <memory>
+#include <set>
+#include <vector>
 
 #include <Geom_Plane.hxx>
 #include <Geom_Line.hxx>
@@ -18,11 +20,18 @@
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
 #include <AIS_ViewController.hxx>
+#include <StdSelect_BRepOwner.hxx>
+#include <TopoDS_TShape.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_Trsf.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
 
 #include "cad_core/Shape.h"
 #include "cad_core/SelectionManager.h"
+#include "cad_core/TessellationService.h"
 #include "cad_sketch/Sketch.h"
+#include "cad_ui/FrameScheduler.h"
+#include "cad_ui/LodShape.h"
 
 namespace cad_ui {
 
@@ -49,11 +58,36 @@ public:
     
     // 形状显示
     void DisplayShape(const cad_core::ShapePtr& shape);
+    void DisplayShapes(const std::vector<cad_core::ShapePtr>& shapes);
     void RemoveShape(const cad_core::ShapePtr& shape);
+    
+    // 批量显示：Begin/End之间的显示和删除不做FitAll/Redraw，选择模式也延后激活，
+    // 最外层EndDisplayBatch时统一刷新一次。可嵌套
+    void BeginDisplayBatch();
+    void EndDisplayBatch();
     void ClearShapes();
+    bool IsShapeDisplayed(const cad_core::ShapePtr& shape) const;
     void RedrawAll();
     virtual QPaintEngine* paintEngine() const;
     
+    // 按需渲染：只标记需要重绘，由帧调度器合并到下一帧。
+    // 立即层（动态高亮、预览）变化用 RequestImmediateRedraw，不重绘整个场景
+    void RequestRedraw();
+    void RequestImmediateRedraw();
+    const FrameStats& GetFrameStats() const;
+    FrameScheduler* GetFrameScheduler() const { return m_frameScheduler; }
+    
+    // 变换预览：直接给已显示形状的现有显示对象叠加局部变换，
+    // 副本则用连接到原显示对象的临时对象表示。不生成几何、不重新划分网格，
+    // ClearShapePreviews 恢复原状
+    bool PreviewShapeTransformation(const cad_core::ShapePtr& shape, const gp_Trsf& transformation);
+    bool AddShapePreviewCopy(const cad_core::ShapePtr& shape, const gp_Trsf& placement);
+    void ClearShapePreviews();
+    
+    // 提交只改位置的移动：现有显示对象改挂到新形状上并叠加局部变换，
+    // 不重新生成显示、不重新划分网格。两者不共享TShape（或形状未显示）时返回false
+    bool MoveShapePresentation(const cad_core::ShapePtr& oldShape, const cad_core::ShapePtr& newShape);
+    
     // 背景和外观
     void SetBackgroundColor(const QColor& color);
     void SetBackgroundGradient(const QColor& color1, const QColor& color2);
@@ -141,7 +175,7 @@ private:
     Qt::MouseButton m_currentMouseButton;
     bool m_isInitialized;
     
-    QTimer* m_redrawTimer;
+    FrameScheduler* m_frameScheduler;
     
     // 选择管理器
     std::unique_ptr<cad_core::SelectionManager> m_selectionManager;
@@ -172,12 +206,92 @@ private:
     // 当前选择模式
     int m_currentSelectionMode;
     
+    // 已按需激活子形状选择模式（顶点/边/面）的形状；光标离开且未被选中时停用，切换选择模式时清空
+    std::set<cad_core::ShapePtr> m_subShapeModeShapes;
+    static const int SUB_SHAPE_ACTIVATION_MARGIN_PX = 4;
+    
+    // 悬停拾取：每帧最多拾取一次；检测到的对象变化时才重绘立即层
+    QTimer* m_hoverTimer;
+    QPoint m_pendingHoverPos;
+    Handle(SelectMgr_EntityOwner) m_hoverOwner;
+    
+    // 批量显示状态
+    int m_displayBatchDepth;
+    bool m_batchNeedsFit;
+    bool m_batchNeedsRedraw;
+    std::vector<Handle(AIS_Shape)> m_batchPendingActivation;
+    
+    // 后台网格划分：网格算好之前只显示一个包围盒线框占位。
+    // 工作线程只划分拓扑副本，算好后在GUI线程把网格挂回文档形状，
+    // 文档形状在任何时候都不会被工作线程写入
+    struct TessellationJob {
+        Handle(AIS_Shape) placeholder;
+        cad_core::ShapePtr meshCopy;
+        std::vector<std::pair<TopoDS_Shape, TopoDS_Shape>> faces;  // (文档面, 副本面)
+        std::vector<std::pair<TopoDS_Shape, TopoDS_Shape>> edges;  // (文档边, 副本边)
+    };
+    std::unique_ptr<cad_core::TessellationService> m_tessellationService;
+    std::map<cad_core::ShapePtr, TessellationJob> m_tessellationPlaceholders;
+    static const int ASYNC_TESSELLATION_FACE_THRESHOLD = 64;
+    
+    // 多细节层次：按屏幕上的投影尺寸为曲面形状选择网格层次，更细的层次在后台生成
+    struct LodJob {
+        cad_core::ShapePtr shape;  // 原形状
+        int level;
+    };
+    std::map<cad_core::ShapePtr, LodJob> m_lodJobs;  // 键为正在划分网格的形状副本
+    double m_lodWorldPerPixel;                       // 上次评估层次时的相机比例
+    static constexpr double LOD_PIXEL_ERROR = 0.5;   // 允许的屏幕弦高误差（像素）
+    static constexpr double LOD_MIN_DETAIL_PX = 32.0;
+    static constexpr double LOD_SCALE_TOLERANCE = 1e-3;
+    
+    // 实例化显示：共享同一TShape的形状（阵列、复制）连接到同一个原型显示对象
+    struct InstancePrototype {
+        Handle(AIS_Shape) presentation;
+        int useCount;
+    };
+    std::map<const TopoDS_TShape*, InstancePrototype> m_instancePrototypes;
+    // 已显示的形状按TShape分组，判断是否出现第二个放置时不必扫描全部形状
+    std::map<const TopoDS_TShape*, std::vector<cad_core::ShapePtr>> m_placementsByTShape;
+    
+    // 经 MoveShapePresentation 移动过的显示对象：显示对象所示形状到文档形状的位置差，
+    // 拾取到的子形状要叠加它才能与文档中的子形状 IsSame
+    std::map<const AIS_InteractiveObject*, TopLoc_Location> m_presentationMoves;
+    
+    // 变换预览：被预览的显示对象及其原局部变换，以及副本预览的临时对象
+    std::map<cad_core::ShapePtr, gp_Trsf> m_previewOriginalTransforms;
+    std::vector<Handle(AIS_InteractiveObject)> m_previewCopies;
+    
     void InitializeOCC();
     void RedrawView();
+    void ActivateShapeSelectionModes(const Handle(AIS_Shape)& aisShape);
+    void ActivateSubShapeModeAt(const QPoint& point);
+    Handle(AIS_Shape) CreateShapePresentation(const cad_core::ShapePtr& shape);
+    Handle(AIS_Shape) CreateInstancePresentation(const cad_core::ShapePtr& shape);
+    void ReleaseInstancePresentation(const Handle(AIS_Shape)& aisShape);
+    void AddPlacement(const cad_core::ShapePtr& shape);
+    void RemovePlacement(const cad_core::ShapePtr& shape);
+    TopoDS_Shape OwnerShapeInModelSpace(const Handle(StdSelect_BRepOwner)& owner) const;
+    bool NeedsAsyncTessellation(const cad_core::ShapePtr& shape) const;
+    double DefaultDeflection(const cad_core::ShapePtr& shape) const;
+    bool HasCurvedFaces(const cad_core::ShapePtr& shape) const;
+    void UpdateLevelsOfDetail();
+    int SelectLevelOfDetail(const cad_core::ShapePtr& shape, const Handle(LodShape)& lodShape,
+                            double worldPerPixel) const;
+    void RequestLevelMesh(const cad_core::ShapePtr& shape, const Handle(LodShape)& lodShape, int level);
+    void OnLevelMeshFinished(const cad_core::ShapePtr& levelShape, bool success);
+    void CancelLevelMeshes(const cad_core::ShapePtr& shape);
+    void DisplayTessellationPlaceholder(const cad_core::ShapePtr& shape);
+    void OnTessellationFinished(const cad_core::ShapePtr& meshCopy, bool success);
+    static void AdoptTessellation(const TessellationJob& job);
+    void FlushDisplayBatch();
     void HandleSelection(const QPoint& point);
+    void UpdateHover(const QPoint& point);
+    void InvalidateHover();
     
 private slots:
-    void OnRedrawTimer();
+    void OnHoverTimer();
+    void OnFrameRendered();
 };
 
 } // namespace cad_ui
\ No newline at end of file
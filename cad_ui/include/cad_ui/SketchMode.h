@@ -2,6 +2,7 @@
 
 #include <QObject>
 #include <QWidget>
+#include <QTimer>
 #include <gp_Pln.hxx>
 #include <gp_Pnt.hxx>
 #include <gp_Dir.hxx>
@@ -183,6 +184,7 @@ private slots:
     void OnCircleCreated(const cad_sketch::SketchCirclePtr& circle);
     void UpdateCirclePreview(const cad_sketch::SketchCirclePtr& previewCircle);
     void OnDrawingCancelled();
+    void OnDragTimer();
     
 
 private:
@@ -236,6 +238,20 @@ private:
     // 清除预览图形的显示
     void ClearPreviewDisplay();
 
+    // 拖动草图点：鼠标事件合并到每帧一次，每帧只做有限次迭代，松开时精确求解
+    cad_sketch::SketchPointPtr m_dragPoint;
+    QPoint m_pendingDragPos;
+    QTimer* m_dragTimer;
+    std::vector<std::pair<cad_sketch::SketchElementPtr, Handle(AIS_Shape)>> m_dragDisplays;
+    static const int DRAG_PICK_RADIUS_PX = 8;
+    
+    bool ScreenToSketch(const QPoint& screenPoint, double& x, double& y) const;
+    cad_sketch::SketchPointPtr FindPointNear(const QPoint& screenPoint) const;
+    bool BeginPointDrag(const QPoint& screenPoint);
+    void DragPointTo(const QPoint& screenPoint);
+    void FinishPointDrag(const QPoint& screenPoint);
+    void RefreshDraggedElements();
+
     static int s_sketchCounter;
 
 };
@@ -69,6 +69,7 @@ private:
     void updatePreview();
     void updateSelectionDisplay();
     void resetAllParameters();
+    std::shared_ptr<cad_core::TransformCommand> createTransformCommand() const;
     
     // UI组件
     QVBoxLayout* m_mainLayout;
@@ -142,6 +143,11 @@ private:
     QDoubleSpinBox* m_scaleFactorY;
     QDoubleSpinBox* m_scaleFactorZ;
     
+    // 复制/阵列
+    QGroupBox* m_copyGroup;
+    QCheckBox* m_copyCheckBox;
+    QSpinBox* m_copyCount;
+    
     // 控制按钮
     QHBoxLayout* m_buttonLayout;
     QPushButton* m_previewButton;
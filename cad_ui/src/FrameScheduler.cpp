@@ -0,0 +1,134 @@
+#include "cad_ui/FrameScheduler.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <Standard_Failure.hxx>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cad_ui {
+
+FrameScheduler::FrameScheduler(QObject* parent)
+    : QObject(parent), m_frameIntervalMs(DEFAULT_FRAME_INTERVAL_MS),
+      m_fullRedrawPending(false), m_immediateRedrawPending(false) {
+    
+    // Pace frames to the display refresh rate when it is known
+    QScreen* screen = QGuiApplication::primaryScreen();
+    if (screen && screen->refreshRate() > 1.0) {
+        m_frameIntervalMs = std::max(1, static_cast<int>(std::floor(1000.0 / screen->refreshRate())));
+    }
+    
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &FrameScheduler::OnFrameTimer);
+}
+
+void FrameScheduler::SetView(const Handle(V3d_View)& view) {
+    m_view = view;
+}
+
+void FrameScheduler::RequestRedraw() {
+    m_stats.requestCount++;
+    if (m_fullRedrawPending) {
+        m_stats.coalescedCount++;
+        return;
+    }
+    
+    m_fullRedrawPending = true;
+    ScheduleFrame();
+}
+
+void FrameScheduler::RequestImmediateRedraw() {
+    m_stats.requestCount++;
+    // A pending full redraw repaints the immediate layer as well
+    if (m_fullRedrawPending || m_immediateRedrawPending) {
+        m_stats.coalescedCount++;
+        return;
+    }
+    
+    m_immediateRedrawPending = true;
+    ScheduleFrame();
+}
+
+void FrameScheduler::SetFrameInterval(int milliseconds) {
+    m_frameIntervalMs = std::max(0, milliseconds);
+}
+
+void FrameScheduler::ResetFrameStats() {
+    m_stats = FrameStats();
+}
+
+void FrameScheduler::ScheduleFrame() {
+    if (m_frameTimer->isActive()) {
+        return;
+    }
+    
+    // Render right away if a frame interval has already passed since the last one,
+    // otherwise wait out the remainder so we never render faster than the display
+    int delay = 0;
+    if (m_sinceLastFrame.isValid()) {
+        qint64 elapsed = m_sinceLastFrame.elapsed();
+        if (elapsed < m_frameIntervalMs) {
+            delay = static_cast<int>(m_frameIntervalMs - elapsed);
+        }
+    }
+    m_frameTimer->start(delay);
+}
+
+void FrameScheduler::OnFrameTimer() {
+    RenderNow();
+}
+
+void FrameScheduler::RenderNow() {
+    m_frameTimer->stop();
+    
+    bool full = m_fullRedrawPending;
+    bool immediate = m_immediateRedrawPending;
+    m_fullRedrawPending = false;
+    m_immediateRedrawPending = false;
+    
+    if (m_view.IsNull() || (!full && !immediate)) {
+        return;
+    }
+    
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    
+    try {
+        if (full) {
+            m_view->Redraw();
+        } else {
+            m_view->RedrawImmediate();
+        }
+    }
+    catch (const Standard_Failure&) {
+        // Keep the scheduler alive; the next request will try again
+    }
+    
+    double frameMs = frameTimer.nsecsElapsed() / 1.0e6;
+    m_sinceLastFrame.restart();
+    RecordFrame(frameMs, !full);
+    
+    emit FrameRendered(frameMs);
+}
+
+void FrameScheduler::RecordFrame(double frameMs, bool immediateOnly) {
+    m_stats.frameCount++;
+    if (immediateOnly) {
+        m_stats.immediateFrameCount++;
+    }
+    m_stats.lastFrameMs = frameMs;
+    m_stats.maxFrameMs = std::max(m_stats.maxFrameMs, frameMs);
+    
+    // Exponential moving average over roughly the last FRAME_TIME_WINDOW frames
+    if (m_stats.frameCount == 1) {
+        m_stats.averageFrameMs = frameMs;
+    } else {
+        const double alpha = 1.0 / FRAME_TIME_WINDOW;
+        m_stats.averageFrameMs += alpha * (frameMs - m_stats.averageFrameMs);
+    }
+}
+
+} // namespace cad_ui
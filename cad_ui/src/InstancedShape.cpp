@@ -0,0 +1,44 @@
+#include "cad_ui/InstancedShape.h"
+
+#include <PrsMgr_PresentationManager.hxx>
+#include <Prs3d_Presentation.hxx>
+
+namespace cad_ui {
+
+IMPLEMENT_STANDARD_RTTIEXT(InstancedShape, AIS_Shape)
+
+InstancedShape::InstancedShape(const TopoDS_Shape& instanceShape, const Handle(AIS_Shape)& prototype)
+    : AIS_Shape(instanceShape.Located(TopLoc_Location())),
+      m_prototype(prototype), m_instanceLocation(instanceShape.Location()) {
+    // The geometry stays in prototype space; the placement is the object transformation,
+    // which both the connected presentation and the selection pick up
+    SetLocalTransformation(m_instanceLocation.Transformation());
+}
+
+TopoDS_Shape InstancedShape::ToInstanceSpace(const TopoDS_Shape& prototypeSubShape) const {
+    return prototypeSubShape.Moved(m_instanceLocation);
+}
+
+void InstancedShape::Compute(const Handle(PrsMgr_PresentationManager)& presentationManager,
+                             const Handle(Prs3d_Presentation)& presentation,
+                             const Standard_Integer mode) {
+    if (m_prototype.IsNull() || (mode != AIS_WireFrame && mode != AIS_Shaded)) {
+        AIS_Shape::Compute(presentationManager, presentation, mode);
+        return;
+    }
+    
+    // Same approach as AIS_ConnectedInteractive: reuse the prototype's structure
+    // instead of building our own primitive arrays
+    presentation->Clear(Standard_False);
+    presentation->DisconnectAll(Graphic3d_TOC_DESCENDANT);
+    if (!m_prototype->HasInteractiveContext()) {
+        m_prototype->SetContext(GetContext());
+    }
+    
+    presentationManager->Connect(this, m_prototype, mode, mode);
+    if (presentationManager->Presentation(m_prototype, mode)->MustBeUpdated()) {
+        presentationManager->Update(m_prototype, mode);
+    }
+}
+
+} // namespace cad_ui
@@ -0,0 +1,72 @@
+#include "cad_ui/LodShape.h"
+
+#include <cmath>
+
+namespace cad_ui {
+
+IMPLEMENT_STANDARD_RTTIEXT(LodShape, AIS_Shape)
+
+LodShape::LodShape(const TopoDS_Shape& shape, double baseDeflection)
+    : AIS_Shape(shape), m_baseDeflection(baseDeflection),
+      m_activeLevel(DEFAULT_LEVEL), m_requestedLevel(DEFAULT_LEVEL) {
+}
+
+double LodShape::GetLevelDeflection(int level) const {
+    return m_baseDeflection * std::pow(LEVEL_RATIO, DEFAULT_LEVEL - level);
+}
+
+void LodShape::SetLevelShape(int level, const TopoDS_Shape& meshedShape) {
+    if (level < 0 || level >= LEVEL_COUNT || level == DEFAULT_LEVEL) {
+        return;
+    }
+    m_levelShapes[level] = meshedShape;
+}
+
+bool LodShape::HasLevel(int level) const {
+    if (level == DEFAULT_LEVEL) {
+        return true;
+    }
+    return level >= 0 && level < LEVEL_COUNT && !m_levelShapes[level].IsNull();
+}
+
+bool LodShape::SetActiveLevel(int level) {
+    if (level == m_activeLevel || !HasLevel(level)) {
+        return false;
+    }
+    
+    m_activeLevel = level;
+    SetToUpdate();
+    return true;
+}
+
+void LodShape::Compute(const Handle(PrsMgr_PresentationManager)& presentationManager,
+                       const Handle(Prs3d_Presentation)& presentation,
+                       const Standard_Integer mode) {
+    // Wireframe and shaded modes draw the active level; everything else, and
+    // selection, always works on the original shape
+    if (m_activeLevel == DEFAULT_LEVEL || (mode != AIS_WireFrame && mode != AIS_Shaded)) {
+        AIS_Shape::Compute(presentationManager, presentation, mode);
+        return;
+    }
+    
+    // The level copy is already meshed at its own deflection: draw it as is,
+    // without letting AIS re-mesh it at the default deflection
+    TopoDS_Shape original = myshape;
+    Standard_Boolean autoTriangulation = myDrawer->IsAutoTriangulation();
+    myshape = m_levelShapes[m_activeLevel];
+    myDrawer->SetAutoTriangulation(Standard_False);
+    
+    try {
+        AIS_Shape::Compute(presentationManager, presentation, mode);
+    }
+    catch (const Standard_Failure&) {
+        myshape = original;
+        myDrawer->SetAutoTriangulation(autoTriangulation);
+        throw;
+    }
+    
+    myshape = original;
+    myDrawer->SetAutoTriangulation(autoTriangulation);
+}
+
+} // namespace cad_ui
@@ -18,6 +18,8 @@
 #include "cad_feature/SweepFeature.h"
 #include "cad_feature/LoftFeature.h"
 #include <TopoDS.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <Standard_Failure.hxx>
 
 #include <QApplication>
 #include <QFileDialog>
@@ -36,6 +38,7 @@
 #include <QFrame>
 #include <QLabel>
 #include <map>
+#include <algorithm>
 #pragma execution_character_set("utf-8")
 
 namespace cad_ui {
@@ -935,6 +938,9 @@ void MainWindow::RefreshUIFromOCAF() {
     
     qDebug() << "Refreshing UI from OCAF document state";
     
+    // One fit/redraw for the whole reload instead of one per shape
+    m_viewer->BeginDisplayBatch();
+    
     // Clear current UI state
     m_viewer->ClearShapes();
     m_documentTree->Clear();
@@ -952,6 +958,8 @@ void MainWindow::RefreshUIFromOCAF() {
         }
     }
     
+    m_viewer->EndDisplayBatch();
+    
     // Clear any selections
     m_viewer->ClearSelection();
     m_viewer->ClearEdgeSelection();
@@ -962,6 +970,53 @@ void MainWindow::RefreshUIFromOCAF() {
     qDebug() << "UI refresh completed";
 }
 
+void MainWindow::ApplyOCAFChanges(const cad_core::ShapeChanges& changes) {
+    if (!m_ocafManager) {
+        return;
+    }
+    
+    // Every shape we are about to take away must be one the viewer knows;
+    // otherwise the view is out of sync with the document and only a full rebuild helps
+    for (const auto& shape : changes.removed) {
+        if (!m_viewer->IsShapeDisplayed(shape)) {
+            RefreshUIFromOCAF();
+            return;
+        }
+    }
+    for (const auto& change : changes.modified) {
+        if (!m_viewer->IsShapeDisplayed(change.first)) {
+            RefreshUIFromOCAF();
+            return;
+        }
+    }
+    
+    qDebug() << "Applying OCAF changes:" << changes.added.size() << "added,"
+             << changes.removed.size() << "removed," << changes.modified.size() << "modified";
+    
+    // Selection may point at shapes that are going away
+    m_viewer->ClearSelection();
+    m_viewer->ClearEdgeSelection();
+    
+    m_viewer->BeginDisplayBatch();
+    
+    for (const auto& shape : changes.removed) {
+        m_viewer->RemoveShape(shape);
+        m_documentTree->RemoveShape(shape);
+    }
+    for (const auto& change : changes.modified) {
+        m_viewer->RemoveShape(change.first);
+        m_documentTree->RemoveShape(change.first);
+        m_viewer->DisplayShape(change.second);
+        m_documentTree->AddShape(change.second);
+    }
+    for (const auto& shape : changes.added) {
+        m_viewer->DisplayShape(shape);
+        m_documentTree->AddShape(shape);
+    }
+    
+    m_viewer->EndDisplayBatch();
+}
+
 void MainWindow::UpdateWindowTitle() {
     QString title = "Ander CAD";
     if (!m_currentFileName.isEmpty()) {
@@ -1057,8 +1112,8 @@ void MainWindow::OnUndo() {
     qDebug() << "OnUndo called - checking undo availability:" << m_ocafManager->CanUndo();
     if (m_ocafManager->Undo()) {
         qDebug() << "Undo operation successful, refreshing UI";
-        // Refresh UI from OCAF document state
-        RefreshUIFromOCAF();
+        // Only touch the shapes the undone transaction changed
+        ApplyOCAFChanges(m_ocafManager->GetLastChanges());
         SetDocumentModified(true);
         UpdateActions();
         statusBar()->showMessage("Undo completed", 2000);
@@ -1073,8 +1128,8 @@ void MainWindow::OnRedo() {
     qDebug() << "OnRedo called - checking redo availability:" << m_ocafManager->CanRedo();
     if (m_ocafManager->Redo()) {
         qDebug() << "Redo operation successful, refreshing UI";
-        // Refresh UI from OCAF document state
-        RefreshUIFromOCAF();
+        // Only touch the shapes the redone transaction changed
+        ApplyOCAFChanges(m_ocafManager->GetLastChanges());
         SetDocumentModified(true);
         UpdateActions();
         statusBar()->showMessage("Redo completed", 2000);
@@ -1308,8 +1363,10 @@ void MainWindow::OnCreateExtrude() {
     extrudeFeature->SetDistance(distance);
     extrudeFeature->SetSketchPlane(m_lastSketchPlane);
 
-    // 4. 执行特征来创建3D形状
-    cad_core::ShapePtr resultShape = extrudeFeature->CreateShape();
+    // 4. 和扫掠、放样一样经特征管理器执行，相同输入直接取缓存结果
+    m_featureManager->AddFeature(extrudeFeature);
+    m_documentTree->AddFeature(extrudeFeature);
+    cad_core::ShapePtr resultShape = ExecuteFeatureForDocument(extrudeFeature);
 
     // 5. 将新形状添加到文档并显示
     if (resultShape && resultShape->IsValid()) {
@@ -1326,6 +1383,25 @@ void MainWindow::OnCreateExtrude() {
     }
     else {
         QMessageBox::critical(this, "拉伸失败", "无法创建拉伸实体。请确保草图是封闭的。");
+        m_featureManager->RemoveFeature(extrudeFeature);
+        m_documentTree->RemoveFeature(extrudeFeature);
+    }
+}
+
+cad_core::ShapePtr MainWindow::ExecuteFeatureForDocument(const cad_feature::FeaturePtr& feature) {
+    m_featureManager->ExecuteFeature(feature);
+    cad_core::ShapePtr featureResult = m_featureManager->GetFeatureResult(feature);
+    if (!featureResult || featureResult->GetOCCTShape().IsNull()) {
+        return nullptr;
+    }
+    
+    // A cached result may already be in the document. The OCAF shape index is keyed
+    // by IsSame, so every document object needs its own topology, not just its own Shape
+    try {
+        BRepBuilderAPI_Copy copier(featureResult->GetOCCTShape(), Standard_True, Standard_False);
+        return std::make_shared<cad_core::Shape>(copier.Shape());
+    } catch (const Standard_Failure& e) {
+        return nullptr;
     }
 }
 
@@ -1954,69 +2030,48 @@ void MainWindow::OnBooleanOperationRequested(BooleanOperationType type,
     
     cad_core::ShapePtr result;
     try {
+        // All targets and tools go to the boolean engine in a single pass
         if (type == BooleanOperationType::Union) {
-            // Combine all targets and tools for union
-            std::vector<cad_core::ShapePtr> allShapes = targets;
-            allShapes.insert(allShapes.end(), tools.begin(), tools.end());
-            result = cad_core::BooleanOperations::Union(allShapes);
+            result = cad_core::BooleanOperations::BooleanOperation(
+                targets, tools, cad_core::BooleanOperations::BooleanType::Union);
         } else if (type == BooleanOperationType::Intersection) {
-            // Use first target as base, intersect with all others
-            result = targets[0];
-            for (size_t i = 1; i < targets.size(); ++i) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Intersection({result, targets[i]});
-                }
-            }
-            for (const auto& tool : tools) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Intersection({result, tool});
-                }
-            }
+            result = cad_core::BooleanOperations::BooleanOperation(
+                targets, tools, cad_core::BooleanOperations::BooleanType::Intersection);
         } else if (type == BooleanOperationType::Difference) {
-            // Use first target as base, subtract all tools
-            result = targets[0];
-            for (const auto& tool : tools) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Difference(result, tool);
-                }
-            }
+            result = cad_core::BooleanOperations::BooleanOperation(
+                targets, tools, cad_core::BooleanOperations::BooleanType::Difference);
         }
         
         if (result) {
+            // A difference whose tools all miss the target returns the target itself:
+            // keep it where it is instead of re-adding it
+            bool resultIsInput = std::find(targets.begin(), targets.end(), result) != targets.end();
+            
             // Add result to document
-            if (m_ocafManager->AddShape(result, (operationName + " Result").toStdString())) {
+            if (resultIsInput || m_ocafManager->AddShape(result, (operationName + " Result").toStdString())) {
+                // Defer fit/redraw/selection activation until all adds and removals are done
+                m_viewer->BeginDisplayBatch();
+                
                 // Display the new result shape
-                m_viewer->DisplayShape(result);
-                m_documentTree->AddShape(result);
+                if (!resultIsInput) {
+                    m_viewer->DisplayShape(result);
+                    m_documentTree->AddShape(result);
+                }
                 
-                // For Union: Remove all original objects (targets and tools) from OCAF
-                // For Intersection/Difference: Remove original and tool objects from OCAF, keep only result
-                if (type == BooleanOperationType::Union) {
-                    // Union: Remove all input objects (targets + tools) from OCAF document
-                    for (const auto& shape : targets) {
-                        m_ocafManager->RemoveShape(shape);  // Remove from OCAF
-                        m_viewer->RemoveShape(shape);       // Remove from 3D view
-                        m_documentTree->RemoveShape(shape); // Remove from document tree
-                    }
-                    for (const auto& shape : tools) {
-                        m_ocafManager->RemoveShape(shape);  // Remove from OCAF
-                        m_viewer->RemoveShape(shape);       // Remove from 3D view
-                        m_documentTree->RemoveShape(shape); // Remove from document tree
-                    }
-                } else {
-                    // Intersection/Difference: Remove original and tool objects from OCAF
-                    for (const auto& shape : targets) {
-                        m_ocafManager->RemoveShape(shape);  // Remove from OCAF
-                        m_viewer->RemoveShape(shape);       // Remove from 3D view
-                        m_documentTree->RemoveShape(shape); // Remove from document tree
-                    }
-                    for (const auto& shape : tools) {
+                // Remove all input objects (targets + tools) from OCAF, keep only the result
+                for (const auto* inputs : {&targets, &tools}) {
+                    for (const auto& shape : *inputs) {
+                        if (shape == result) {
+                            continue;
+                        }
                         m_ocafManager->RemoveShape(shape);  // Remove from OCAF
                         m_viewer->RemoveShape(shape);       // Remove from 3D view
                         m_documentTree->RemoveShape(shape); // Remove from document tree
                     }
                 }
                 
+                m_viewer->EndDisplayBatch();
+                
                 m_ocafManager->CommitTransaction();
                 SetDocumentModified(true);
                 UpdateActions();
@@ -2169,7 +2224,30 @@ void MainWindow::OnTransformOperationRequested(std::shared_ptr<cad_core::Transfo
         }
         
         // Execute the transform command to get transformed shapes
-        if (command->Execute()) {
+        bool executed = command->Execute();
+        if (executed && command->IsCopyMode()) {
+            // Copies/patterns keep the originals; rigid copies share their TShape,
+            // and the viewer draws them as instances of one mesh
+            auto copies = command->GetTransformedShapes();
+            
+            m_ocafManager->StartTransaction("Copy Objects");
+            for (const auto& copy : copies) {
+                if (!m_ocafManager->AddShape(copy)) {
+                    m_ocafManager->AbortTransaction();
+                    QMessageBox::warning(this, "错误", "无法添加副本");
+                    return;
+                }
+            }
+            m_ocafManager->CommitTransaction();
+            
+            m_viewer->DisplayShapes(copies);
+            for (const auto& copy : copies) {
+                m_documentTree->AddShape(copy);
+            }
+            SetDocumentModified(true);
+            
+            statusBar()->showMessage(QString("复制完成: %1 个副本").arg(copies.size()), 2000);
+        } else if (executed) {
             // Get original and transformed shapes
             auto originalShapes = m_currentTransformDialog->getSelectedObjects();
             auto transformedShapes = command->GetTransformedShapes();
@@ -2178,27 +2256,34 @@ void MainWindow::OnTransformOperationRequested(std::shared_ptr<cad_core::Transfo
             m_ocafManager->StartTransaction("Transform Objects");
             
             // Replace shapes in OCAF document
+            m_viewer->BeginDisplayBatch();
             for (size_t i = 0; i < originalShapes.size() && i < transformedShapes.size(); ++i) {
                 if (m_ocafManager->ReplaceShape(originalShapes[i], transformedShapes[i])) {
-                    // Update display
-                    m_viewer->RemoveShape(originalShapes[i]);
-                    m_viewer->DisplayShape(transformedShapes[i]);
+                    // Location-only moves keep the existing presentation and its mesh,
+                    // as the preview does; scaled shapes have new geometry to display
+                    if (!m_viewer->MoveShapePresentation(originalShapes[i], transformedShapes[i])) {
+                        m_viewer->RemoveShape(originalShapes[i]);
+                        m_viewer->DisplayShape(transformedShapes[i]);
+                    }
                     
                     // Update document tree
                     m_documentTree->RemoveShape(originalShapes[i]);
                     m_documentTree->AddShape(transformedShapes[i]);
                 } else {
+                    m_viewer->EndDisplayBatch();
                     m_ocafManager->AbortTransaction();
                     QMessageBox::warning(this, "错误", "无法更新形状");
                     return;
                 }
             }
+            m_viewer->EndDisplayBatch();
             
             // Commit transaction
             m_ocafManager->CommitTransaction();
             
-            // Update display and mark as modified
-            RefreshUIFromOCAF();
+            // Only the moved shapes changed; selected sub-shapes still refer to the old placement
+            m_viewer->ClearSelection();
+            m_viewer->ClearEdgeSelection();
             SetDocumentModified(true);
             
             // Update status bar
@@ -2224,30 +2309,30 @@ void MainWindow::OnTransformPreviewRequested(std::shared_ptr<cad_core::Transform
     }
     
     try {
-        // Clear any existing preview
-        if (m_previewActive) {
-            OnTransformResetRequested();
-        }
-        
-        // Get preview shapes from command
-        auto previewShapes = command->GetTransformedShapes();
+        // The preview only moves the existing presentations: no geometry is built,
+        // nothing is meshed, so it keeps up with a dragged slider.
+        // Previous previews are cleared in the same frame the new ones are set
+        m_viewer->ClearShapePreviews();
         
-        if (!previewShapes.empty()) {
-            // Store preview shapes
-            m_previewShapes = previewShapes;
-            m_previewActive = true;
+        std::vector<gp_Trsf> placements = command->GetPlacements();
+        for (const auto& shape : command->GetOriginalShapes()) {
+            if (!shape || !shape->IsValid()) {
+                continue;
+            }
             
-            // Display preview shapes with a different color/style
-            for (const auto& shape : m_previewShapes) {
-                if (shape && shape->IsValid()) {
-                    // TODO: Set preview material/color (semi-transparent or different color)
-                    m_viewer->DisplayShape(shape);
+            if (command->IsCopyMode()) {
+                // Copies appear next to the untouched original
+                for (const gp_Trsf& placement : placements) {
+                    m_viewer->AddShapePreviewCopy(shape, placement);
                 }
+            } else if (!placements.empty()) {
+                m_viewer->PreviewShapeTransformation(shape, placements.front());
             }
-            
-            // Update display
-            m_viewer->update();
         }
+        m_previewActive = true;
+    } catch (const Standard_Failure& e) {
+        m_viewer->ClearShapePreviews();
+        QMessageBox::warning(this, "错误", QString("预览生成失败: %1").arg(e.GetMessageString()));
     } catch (const std::exception& e) {
         QMessageBox::warning(this, "错误", QString("预览生成失败: %1").arg(e.what()));
     }
@@ -2258,19 +2343,9 @@ void MainWindow::OnTransformResetRequested() {
         return;
     }
     
-    // Remove preview shapes from display
-    for (const auto& shape : m_previewShapes) {
-        if (shape) {
-            m_viewer->RemoveShape(shape);
-        }
-    }
-    
-    // Clear preview data
-    m_previewShapes.clear();
+    // Restore the previewed presentations and drop preview copies
+    m_viewer->ClearShapePreviews();
     m_previewActive = false;
-    
-    // Update display
-    m_viewer->update();
 }
 
 // =============================================================================
@@ -2511,8 +2586,8 @@ void MainWindow::OnSweepOperationRequested(const cad_sketch::SketchPtr& profile,
     m_featureManager->AddFeature(sweepFeature);
     m_documentTree->AddFeature(sweepFeature);
 
-    // 执行特征，创建三维模型
-    cad_core::ShapePtr resultShape = sweepFeature->CreateShape();
+    // 执行特征，创建三维模型（输入与之前相同时直接取缓存结果）
+    cad_core::ShapePtr resultShape = ExecuteFeatureForDocument(sweepFeature);
 
     // 检查结果并更新UI
     if (resultShape && resultShape->IsValid()) {
@@ -2631,7 +2706,7 @@ void MainWindow::onVisibilityToggled(const QVariant& itemData)
                 isNowVisible = true;
             }
         }
-        m_viewer->GetView()->Redraw(); // 统一重绘
+        m_viewer->RequestRedraw(); // 统一重绘
 
         m_documentTree->setItemVisibilityState(itemData, isNowVisible);
     }
@@ -2652,8 +2727,8 @@ void MainWindow::OnLoftOperationRequested(const std::vector<cad_sketch::SketchPt
     m_featureManager->AddFeature(loftFeature);
     m_documentTree->AddFeature(loftFeature);
 
-    // 3. 执行特征，创建三维模型
-    cad_core::ShapePtr resultShape = loftFeature->CreateShape();
+    // 3. 执行特征，创建三维模型（输入与之前相同时直接取缓存结果）
+    cad_core::ShapePtr resultShape = ExecuteFeatureForDocument(loftFeature);
 
     // 4. 检查结果并更新UI
     if (resultShape && resultShape->IsValid()) {
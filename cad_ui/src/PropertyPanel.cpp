@@ -18,11 +18,19 @@ PropertyPanel::PropertyPanel(QWidget* parent) : QWidget(parent) {
     
     setLayout(m_mainLayout);
     
+    m_propertiesTimer = new QTimer(this);
+    m_propertiesTimer->setInterval(PROPERTIES_POLL_MS);
+    connect(m_propertiesTimer, &QTimer::timeout, this, &PropertyPanel::OnPropertiesPollTimer);
+    
     // Initialize with empty state
     Clear();
 }
 
 void PropertyPanel::SetShape(const cad_core::ShapePtr& shape) {
+    m_propertiesTimer->stop();
+    m_pendingProperties = {};
+    m_shownEstimate = false;
+    m_propertiesFailed = false;
     m_currentShape = shape;
     m_currentFeature.reset();
     
@@ -31,6 +39,8 @@ void PropertyPanel::SetShape(const cad_core::ShapePtr& shape) {
 }
 
 void PropertyPanel::SetFeature(const cad_feature::FeaturePtr& feature) {
+    m_propertiesTimer->stop();
+    m_pendingProperties = {};
     m_currentFeature = feature;
     m_currentShape.reset();
     
@@ -39,6 +49,8 @@ void PropertyPanel::SetFeature(const cad_feature::FeaturePtr& feature) {
 }
 
 void PropertyPanel::Clear() {
+    m_propertiesTimer->stop();
+    m_pendingProperties = {};
     m_currentShape.reset();
     m_currentFeature.reset();
     ClearProperties();
@@ -60,14 +72,89 @@ void PropertyPanel::CreateShapeProperties() {
     AddProperty("Valid", m_currentShape->IsValid() ? "Yes" : "No");
     
     if (m_currentShape->IsValid()) {
-        AddProperty("Volume", m_currentShape->Volume());
-        AddProperty("Area", m_currentShape->Area());
+        // Never compute on the GUI thread: show cached values or start a background job
+        cad_core::Shape::PropertiesPtr properties = m_currentShape->GetCachedProperties();
+        if (properties) {
+            AddShapeProperties(*properties);
+        } else if (m_propertiesFailed) {
+            AddProperty("Volume", "Unavailable");
+            AddProperty("Area", "Unavailable");
+        } else {
+            // Show the fast estimate while the exact values are still being refined
+            cad_core::Shape::PropertiesPtr estimate = m_currentShape->GetEstimatedProperties();
+            if (estimate) {
+                AddShapeProperties(*estimate);
+                AddProperty("Accuracy", "Estimate, refining...");
+            } else {
+                AddProperty("Volume", "Computing...");
+                AddProperty("Area", "Computing...");
+            }
+            m_pendingProperties = m_currentShape->ComputePropertiesAsync();
+            m_propertiesTimer->start();
+        }
     }
     
     // Add stretch at the end
     m_contentLayout->addStretch();
 }
 
+void PropertyPanel::AddShapeProperties(const cad_core::ShapeProperties& properties) {
+    AddProperty("Volume", properties.volume);
+    AddProperty("Area", properties.area);
+    AddProperty("Centroid", QString("(%1, %2, %3)")
+        .arg(properties.centroid.X(), 0, 'f', 3)
+        .arg(properties.centroid.Y(), 0, 'f', 3)
+        .arg(properties.centroid.Z(), 0, 'f', 3));
+    AddProperty("Inertia", QString("Ixx %1, Iyy %2, Izz %3")
+        .arg(properties.inertia.Value(1, 1), 0, 'f', 3)
+        .arg(properties.inertia.Value(2, 2), 0, 'f', 3)
+        .arg(properties.inertia.Value(3, 3), 0, 'f', 3));
+    
+    if (!properties.boundingBox.IsVoid()) {
+        double xMin, yMin, zMin, xMax, yMax, zMax;
+        properties.boundingBox.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        AddProperty("Size", QString("%1 x %2 x %3")
+            .arg(xMax - xMin, 0, 'f', 3)
+            .arg(yMax - yMin, 0, 'f', 3)
+            .arg(zMax - zMin, 0, 'f', 3));
+    }
+    
+    AddProperty("Solids", QString::number(properties.solidCount));
+    AddProperty("Faces", QString::number(properties.faceCount));
+    AddProperty("Edges", QString::number(properties.edgeCount));
+    AddProperty("Vertices", QString::number(properties.vertexCount));
+}
+
+void PropertyPanel::OnPropertiesPollTimer() {
+    if (!m_pendingProperties.valid()) {
+        m_propertiesTimer->stop();
+        return;
+    }
+    
+    if (m_pendingProperties.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        // Swap in the estimate as soon as it shows up
+        if (!m_shownEstimate && m_currentShape && m_currentShape->GetEstimatedProperties()) {
+            m_shownEstimate = true;
+            ClearProperties();
+            CreateShapeProperties();
+        }
+        return;
+    }
+    
+    m_propertiesTimer->stop();
+    try {
+        m_pendingProperties.get();
+    } catch (...) {
+        // Don't restart a job that already failed for this shape
+        m_propertiesFailed = true;
+    }
+    m_pendingProperties = {};
+    
+    // The result is in the shape's cache now, so a rebuild fills in the values
+    ClearProperties();
+    CreateShapeProperties();
+}
+
 void PropertyPanel::CreateFeatureProperties() {
     if (!m_currentFeature) {
         return;
@@ -1,5 +1,7 @@
 ﻿#include "cad_ui/QtOccView.h"
 #include "cad_ui/SketchMode.h"
+#include "cad_ui/LodShape.h"
+#include "cad_ui/InstancedShape.h"
 #include <gp_Ax1.hxx>      
 #include <gp_Dir.hxx>      
 #include <gp_Pnt.hxx>      
@@ -25,6 +27,31 @@
 #include <gp_Trsf.hxx>
 #include <Graphic3d_TransformPers.hxx>
 #include <gp_Trsf.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepTools.hxx>
+#include <TopExp_Explorer.hxx>
+#include <Prs3d.hxx>
+#include <Precision.hxx>
+#include <gp_Lin.hxx>
+#include <gp_Vec.hxx>
+#include <Bnd_Box.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRep_Builder.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <BRep_Tool.hxx>
+#include <BRep_TEdge.hxx>
+#include <BRep_CurveRepresentation.hxx>
+#include <BRep_ListIteratorOfListOfCurveRepresentation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <BRepAdaptor_Surface.hxx>
+#include <TopLoc_Location.hxx>
+#include <AIS_ConnectedInteractive.hxx>
+#include <Graphic3d_ZLayerId.hxx>
+#include <algorithm>
+#include <cmath>
 
 
 #ifdef _WIN32
@@ -40,7 +67,9 @@ namespace cad_ui {
 
 QtOccView::QtOccView(QWidget* parent) 
     : QWidget(parent), m_isInitialized(false), m_currentMouseButton(Qt::NoButton),
-      m_currentSelectedShape(nullptr), m_currentSelectionMode(0) {
+      m_currentSelectedShape(nullptr), m_currentSelectionMode(0),
+      m_displayBatchDepth(0), m_batchNeedsFit(false), m_batchNeedsRedraw(false),
+      m_lodWorldPerPixel(0.0) {
     
     // Set widget attributes to reduce flicker
     setAttribute(Qt::WA_PaintOnScreen);
@@ -52,14 +81,21 @@ QtOccView::QtOccView(QWidget* parent)
     setFocusPolicy(Qt::StrongFocus);
     setAutoFillBackground(false);  // Don't fill background to reduce flicker
     
-    // Initialize timer for redraw
-    m_redrawTimer = new QTimer(this);
-    m_redrawTimer->setSingleShot(true);
-    connect(m_redrawTimer, &QTimer::timeout, this, &QtOccView::OnRedrawTimer);
+    // All redraws go through the scheduler, which coalesces them to one per frame
+    m_frameScheduler = new FrameScheduler(this);
+    connect(m_frameScheduler, &FrameScheduler::FrameRendered, this, &QtOccView::OnFrameRendered);
+    
+    // Hover picking and cursor feedback run at most once per frame
+    m_hoverTimer = new QTimer(this);
+    m_hoverTimer->setSingleShot(true);
+    connect(m_hoverTimer, &QTimer::timeout, this, &QtOccView::OnHoverTimer);
     
     // Initialize selection manager
     m_selectionManager = std::make_unique<cad_core::SelectionManager>();
     
+    // Background meshing for large shapes
+    m_tessellationService = std::make_unique<cad_core::TessellationService>();
+    
     // Initialize sketch mode (delayed initialization to avoid crash)
     m_sketchMode = nullptr; // Will be initialized on first use
     
@@ -93,6 +129,7 @@ bool QtOccView::InitViewer() {
 
         // Create view
         m_view = m_viewer->CreateView();
+        m_frameScheduler->SetView(m_view);
 
         // Create window
 #ifdef _WIN32
@@ -144,9 +181,12 @@ bool QtOccView::InitViewer() {
         if (!preHilightDrawer.IsNull()) {
             preHilightDrawer->SetColor(Quantity_NOC_ORANGE);
             preHilightDrawer->SetDisplayMode(1); // Shaded mode
+            // Keep hover highlight in the immediate layer so it never forces a full redraw
+            preHilightDrawer->SetZLayer(Graphic3d_ZLayerId_Top);
         }
 
         // Set up selection manager
+        m_selectionManager->SetLazySubShapeActivation(true);
         m_selectionManager->SetContext(m_context);
         m_selectionManager->SetView(m_view);
 
@@ -155,7 +195,7 @@ bool QtOccView::InitViewer() {
         // Initial view setup and render
         FitAll();
         ShowAxes(false);  // 默认显示坐标轴
-        m_view->Redraw();  // 确保初始渲染
+        RequestRedraw();  // 确保初始渲染
 
         return true;
     }
@@ -170,21 +210,21 @@ void QtOccView::FitAll() {
     
     m_view->FitAll();
     m_view->ZFitAll();
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ZoomIn() {
     if (m_view.IsNull()) return;
     
     m_view->SetZoom(1.5);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ZoomOut() {
     if (m_view.IsNull()) return;
     
     m_view->SetZoom(0.75);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::Pan(int dx, int dy) {
@@ -205,11 +245,11 @@ void QtOccView::SetViewMode(const QString& mode) {
     if (m_view.IsNull()) return;
     
     if (mode == "wireframe") {
-        m_context->SetDisplayMode(AIS_WireFrame, Standard_True);
+        m_context->SetDisplayMode(AIS_WireFrame, Standard_False);
     } else if (mode == "shaded") {
-        m_context->SetDisplayMode(AIS_Shaded, Standard_True);
+        m_context->SetDisplayMode(AIS_Shaded, Standard_False);
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::SetProjectionMode(bool orthographic) {
@@ -220,7 +260,7 @@ void QtOccView::SetProjectionMode(bool orthographic) {
     } else {
         m_view->Camera()->SetProjectionType(Graphic3d_Camera::Projection_Perspective);
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::DisplayShape(const cad_core::ShapePtr& shape) {
@@ -228,29 +268,570 @@ void QtOccView::DisplayShape(const cad_core::ShapePtr& shape) {
         return;
     }
     
-    Handle(AIS_Shape) aisShape = new AIS_Shape(shape->GetOCCTShape());
+    // Large unmeshed shapes are tessellated on worker threads; show their box meanwhile
+    if (NeedsAsyncTessellation(shape)) {
+        DisplayTessellationPlaceholder(shape);
+        return;
+    }
     
-    // Set shape properties for better visibility
-    aisShape->SetColor(Quantity_NOC_ORANGE);
-    aisShape->SetTransparency(0.0);
+    Handle(AIS_Shape) aisShape = CreateShapePresentation(shape);
     
     m_context->Display(aisShape, Standard_False);
     
     // Store mapping for selection synchronization
     m_shapeToAIS[shape] = aisShape;
+    AddPlacement(shape);
+    
+    // Inside a batch, selection, fit and redraw all wait for the single flush
+    if (m_displayBatchDepth > 0) {
+        m_batchPendingActivation.push_back(aisShape);
+        m_batchNeedsFit = true;
+        m_batchNeedsRedraw = true;
+        return;
+    }
     
-    // Enable selection modes for this shape
-    m_context->SetSelectionModeActive(aisShape, 0, Standard_True); // Shape
-    m_context->SetSelectionModeActive(aisShape, 1, Standard_True); // Vertex
-    m_context->SetSelectionModeActive(aisShape, 2, Standard_True); // Edge
-    m_context->SetSelectionModeActive(aisShape, 4, Standard_True); // Face
+    ActivateShapeSelectionModes(aisShape);
     
     // Fit all objects in view to ensure visibility and render
     m_view->FitAll();
-    m_view->Redraw();
+    RequestRedraw();
+}
+
+void QtOccView::DisplayShapes(const std::vector<cad_core::ShapePtr>& shapes) {
+    BeginDisplayBatch();
+    for (const auto& shape : shapes) {
+        DisplayShape(shape);
+    }
+    EndDisplayBatch();
+}
+
+void QtOccView::BeginDisplayBatch() {
+    m_displayBatchDepth++;
+}
+
+void QtOccView::EndDisplayBatch() {
+    if (m_displayBatchDepth == 0) {
+        return;
+    }
+    
+    m_displayBatchDepth--;
+    if (m_displayBatchDepth == 0) {
+        FlushDisplayBatch();
+    }
+}
+
+void QtOccView::FlushDisplayBatch() {
+    if (m_context.IsNull() || m_view.IsNull()) {
+        m_batchPendingActivation.clear();
+        return;
+    }
+    
+    // Shapes removed again inside the batch are no longer in the context
+    for (const auto& aisShape : m_batchPendingActivation) {
+        if (m_context->IsDisplayed(aisShape)) {
+            ActivateShapeSelectionModes(aisShape);
+        }
+    }
+    m_batchPendingActivation.clear();
+    
+    if (m_batchNeedsFit) {
+        m_view->FitAll();
+    }
+    if (m_batchNeedsRedraw) {
+        RequestRedraw();
+    }
+    
+    m_batchNeedsFit = false;
+    m_batchNeedsRedraw = false;
+}
+
+Handle(AIS_Shape) QtOccView::CreateShapePresentation(const cad_core::ShapePtr& shape) {
+    // Further placements of already displayed geometry share one prototype presentation
+    Handle(AIS_Shape) aisShape = CreateInstancePresentation(shape);
+    if (!aisShape.IsNull()) {
+        return aisShape;
+    }
+    
+    // Curved shapes get level-of-detail meshes; planar faces mesh the same at any deflection
+    if (HasCurvedFaces(shape)) {
+        aisShape = new LodShape(shape->GetOCCTShape(), DefaultDeflection(shape));
+        m_lodWorldPerPixel = 0.0;  // evaluate levels again on the next frame
+    } else {
+        aisShape = new AIS_Shape(shape->GetOCCTShape());
+    }
     
-    // Force immediate rendering
-    update();
+    // Set shape properties for better visibility
+    aisShape->SetColor(Quantity_NOC_ORANGE);
+    aisShape->SetTransparency(0.0);
+    
+    return aisShape;
+}
+
+Handle(AIS_Shape) QtOccView::CreateInstancePresentation(const cad_core::ShapePtr& shape) {
+    const TopoDS_Shape& occShape = shape->GetOCCTShape();
+    const TopoDS_TShape* key = occShape.TShape().get();
+    
+    auto prototype = m_instancePrototypes.find(key);
+    if (prototype == m_instancePrototypes.end()) {
+        // Only worth a prototype once a second placement of the same TShape shows up
+        auto placements = m_placementsByTShape.find(key);
+        if (placements == m_placementsByTShape.end() ||
+            std::none_of(placements->second.begin(), placements->second.end(),
+                         [&shape](const cad_core::ShapePtr& placed) { return placed != shape; })) {
+            return Handle(AIS_Shape)();
+        }
+        
+        // The prototype lives in TShape space and is never displayed itself
+        Handle(AIS_Shape) prototypePrs = new AIS_Shape(occShape.Located(TopLoc_Location()));
+        prototypePrs->SetColor(Quantity_NOC_ORANGE);
+        prototypePrs->SetTransparency(0.0);
+        prototype = m_instancePrototypes.emplace(key, InstancePrototype{prototypePrs, 0}).first;
+        
+        // The first placement was displayed on its own before the pattern existed;
+        // move it onto the prototype too, so the TShape is uploaded only once
+        for (const auto& placed : placements->second) {
+            auto it = m_shapeToAIS.find(placed);
+            if (placed == shape || it == m_shapeToAIS.end() || it->second.IsNull() ||
+                !Handle(InstancedShape)::DownCast(it->second).IsNull()) {
+                continue;
+            }
+            const Handle(AIS_Shape) previous = it->second;
+            
+            CancelLevelMeshes(placed);
+            m_subShapeModeShapes.erase(placed);
+            m_previewOriginalTransforms.erase(placed);
+            m_presentationMoves.erase(previous.get());
+            m_context->Remove(previous, Standard_False);
+            
+            prototype->second.useCount++;
+            Handle(InstancedShape) instance = new InstancedShape(placed->GetOCCTShape(), prototypePrs);
+            instance->SetColor(Quantity_NOC_ORANGE);
+            instance->SetTransparency(0.0);
+            it->second = instance;
+            
+            m_context->Display(instance, Standard_False);
+            if (m_displayBatchDepth > 0) {
+                m_batchPendingActivation.push_back(instance);
+            } else {
+                ActivateShapeSelectionModes(instance);
+            }
+        }
+    }
+    
+    prototype->second.useCount++;
+    Handle(InstancedShape) instance = new InstancedShape(occShape, prototype->second.presentation);
+    instance->SetColor(Quantity_NOC_ORANGE);
+    instance->SetTransparency(0.0);
+    return instance;
+}
+
+void QtOccView::AddPlacement(const cad_core::ShapePtr& shape) {
+    std::vector<cad_core::ShapePtr>& placements = m_placementsByTShape[shape->GetOCCTShape().TShape().get()];
+    if (std::find(placements.begin(), placements.end(), shape) == placements.end()) {
+        placements.push_back(shape);
+    }
+}
+
+void QtOccView::RemovePlacement(const cad_core::ShapePtr& shape) {
+    auto it = m_placementsByTShape.find(shape->GetOCCTShape().TShape().get());
+    if (it == m_placementsByTShape.end()) {
+        return;
+    }
+    it->second.erase(std::remove(it->second.begin(), it->second.end(), shape), it->second.end());
+    if (it->second.empty()) {
+        m_placementsByTShape.erase(it);
+    }
+}
+
+void QtOccView::ReleaseInstancePresentation(const Handle(AIS_Shape)& aisShape) {
+    Handle(InstancedShape) instance = Handle(InstancedShape)::DownCast(aisShape);
+    if (instance.IsNull()) {
+        return;
+    }
+    
+    auto prototype = m_instancePrototypes.find(instance->Shape().TShape().get());
+    if (prototype != m_instancePrototypes.end() && --prototype->second.useCount <= 0) {
+        m_instancePrototypes.erase(prototype);
+    }
+}
+
+TopoDS_Shape QtOccView::OwnerShapeInModelSpace(const Handle(StdSelect_BRepOwner)& owner) const {
+    // Instances are picked in prototype space; move the sub-shape onto the instance
+    Handle(InstancedShape) instance = Handle(InstancedShape)::DownCast(owner->Selectable());
+    TopoDS_Shape shape = instance.IsNull() ? owner->Shape() : instance->ToInstanceSpace(owner->Shape());
+    
+    // Then onto the document shape of a presentation moved after it was displayed
+    auto move = m_presentationMoves.find(owner->Selectable().get());
+    return move == m_presentationMoves.end() ? shape : shape.Moved(move->second);
+}
+
+bool QtOccView::NeedsAsyncTessellation(const cad_core::ShapePtr& shape) const {
+    if (!m_tessellationService || m_context.IsNull()) {
+        return false;
+    }
+    
+    // Primitives mesh in no time; only hand off shapes with many faces
+    int faceCount = 0;
+    for (TopExp_Explorer exp(shape->GetOCCTShape(), TopAbs_FACE); exp.More(); exp.Next()) {
+        if (++faceCount > ASYNC_TESSELLATION_FACE_THRESHOLD) {
+            break;
+        }
+    }
+    if (faceCount <= ASYNC_TESSELLATION_FACE_THRESHOLD) {
+        return false;
+    }
+    
+    // Already meshed finely enough: AIS will reuse the triangulation
+    return !BRepTools::Triangulation(shape->GetOCCTShape(), DefaultDeflection(shape));
+}
+
+double QtOccView::DefaultDeflection(const cad_core::ShapePtr& shape) const {
+    const Handle(Prs3d_Drawer)& drawer = m_context->DefaultDrawer();
+    return Prs3d::GetDeflection(shape->GetBoundingBox(), drawer->DeviationCoefficient(),
+                                drawer->MaximalChordialDeviation());
+}
+
+bool QtOccView::HasCurvedFaces(const cad_core::ShapePtr& shape) const {
+    for (TopExp_Explorer exp(shape->GetOCCTShape(), TopAbs_FACE); exp.More(); exp.Next()) {
+        BRepAdaptor_Surface surface(TopoDS::Face(exp.Current()), Standard_False);
+        if (surface.GetType() != GeomAbs_Plane) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void QtOccView::OnFrameRendered() {
+    UpdateLevelsOfDetail();
+}
+
+void QtOccView::UpdateLevelsOfDetail() {
+    if (m_view.IsNull() || m_context.IsNull() || m_shapeToAIS.empty()) {
+        return;
+    }
+    
+    // Levels only depend on the camera scale; nothing to do while it stays put
+    double worldPerPixel = m_view->Convert(1);
+    if (worldPerPixel <= 0.0 || std::abs(worldPerPixel - m_lodWorldPerPixel) <= LOD_SCALE_TOLERANCE * worldPerPixel) {
+        return;
+    }
+    m_lodWorldPerPixel = worldPerPixel;
+    
+    bool changed = false;
+    for (const auto& pair : m_shapeToAIS) {
+        Handle(LodShape) lodShape = Handle(LodShape)::DownCast(pair.second);
+        if (lodShape.IsNull()) {
+            continue;
+        }
+        
+        int level = SelectLevelOfDetail(pair.first, lodShape, worldPerPixel);
+        if (level == lodShape->GetRequestedLevel()) {
+            continue;
+        }
+        lodShape->SetRequestedLevel(level);
+        
+        // Show the level right away if we have it, otherwise keep the current one until it is meshed
+        if (lodShape->HasLevel(level)) {
+            if (lodShape->SetActiveLevel(level)) {
+                m_context->Redisplay(lodShape, Standard_False);
+                changed = true;
+            }
+        } else {
+            RequestLevelMesh(pair.first, lodShape, level);
+        }
+    }
+    
+    if (changed) {
+        RequestRedraw();
+    }
+}
+
+int QtOccView::SelectLevelOfDetail(const cad_core::ShapePtr& shape, const Handle(LodShape)& lodShape,
+                                   double worldPerPixel) const {
+    // Shapes covering only a few pixels never need more than the coarse mesh
+    const Bnd_Box& box = shape->GetBoundingBox();
+    double screenSize = box.IsVoid() ? 0.0 : std::sqrt(box.SquareExtent()) / worldPerPixel;
+    if (screenSize < LOD_MIN_DETAIL_PX) {
+        return 0;
+    }
+    
+    // Coarsest level whose chordal error stays below LOD_PIXEL_ERROR on screen
+    for (int level = 0; level < LodShape::LEVEL_COUNT; ++level) {
+        if (lodShape->GetLevelDeflection(level) / worldPerPixel <= LOD_PIXEL_ERROR) {
+            return level;
+        }
+    }
+    return LodShape::LEVEL_COUNT - 1;
+}
+
+void QtOccView::RequestLevelMesh(const cad_core::ShapePtr& shape, const Handle(LodShape)& lodShape, int level) {
+    for (const auto& job : m_lodJobs) {
+        if (job.second.shape == shape && job.second.level == level) {
+            return;
+        }
+    }
+    
+    // Each level lives on its own topology copy, so meshing it on a worker never
+    // touches the triangulation the displayed presentation and selection use.
+    // Surfaces and curves stay shared: a level costs its mesh, not another B-Rep.
+    // Copy the presented shape: committed moves live in the object transformation
+    TopoDS_Shape copy;
+    try {
+        BRepBuilderAPI_Copy copier(lodShape->Shape(), Standard_False, Standard_False);
+        copy = copier.Shape();
+    } catch (const Standard_Failure& e) {
+        return;
+    }
+    
+    auto levelShape = std::make_shared<cad_core::Shape>(copy);
+    m_lodJobs[levelShape] = LodJob{shape, level};
+    
+    double deflection = lodShape->GetLevelDeflection(level);
+    double angle = m_context->DefaultDrawer()->DeviationAngle() *
+                   std::sqrt(deflection / lodShape->GetBaseDeflection());
+    
+    m_tessellationService->Submit(levelShape, deflection, angle,
+        [this](const cad_core::ShapePtr& meshedShape, bool success) {
+            QMetaObject::invokeMethod(this, [this, meshedShape, success]() {
+                OnLevelMeshFinished(meshedShape, success);
+            }, Qt::QueuedConnection);
+        });
+}
+
+void QtOccView::OnLevelMeshFinished(const cad_core::ShapePtr& levelShape, bool success) {
+    auto job = m_lodJobs.find(levelShape);
+    if (job == m_lodJobs.end()) {
+        return;  // cancelled: the shape was removed meanwhile
+    }
+    LodJob finished = job->second;
+    m_lodJobs.erase(job);
+    
+    auto it = m_shapeToAIS.find(finished.shape);
+    if (!success || it == m_shapeToAIS.end() || m_context.IsNull()) {
+        return;
+    }
+    Handle(LodShape) lodShape = Handle(LodShape)::DownCast(it->second);
+    if (lodShape.IsNull()) {
+        return;
+    }
+    
+    lodShape->SetLevelShape(finished.level, levelShape->GetOCCTShape());
+    
+    // The camera may have moved on to another level while this one was meshing
+    if (lodShape->GetRequestedLevel() == finished.level && lodShape->SetActiveLevel(finished.level)) {
+        m_context->Redisplay(lodShape, Standard_False);
+        RequestRedraw();
+    }
+}
+
+void QtOccView::CancelLevelMeshes(const cad_core::ShapePtr& shape) {
+    for (auto it = m_lodJobs.begin(); it != m_lodJobs.end();) {
+        if (it->second.shape == shape) {
+            m_tessellationService->Cancel(it->first);
+            it = m_lodJobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QtOccView::DisplayTessellationPlaceholder(const cad_core::ShapePtr& shape) {
+    // Wireframe box; enlarged a little so flat shapes still give a valid box
+    Bnd_Box box = shape->GetBoundingBox();
+    box.Enlarge(Precision::Confusion());
+    
+    Handle(AIS_Shape) placeholder;
+    try {
+        BRepPrimAPI_MakeBox makeBox(box.CornerMin(), box.CornerMax());
+        placeholder = new AIS_Shape(makeBox.Shape());
+        placeholder->SetDisplayMode(AIS_WireFrame);
+        placeholder->SetColor(Quantity_NOC_GRAY70);
+        m_context->Display(placeholder, AIS_WireFrame, -1, Standard_False);
+    } catch (const Standard_Failure& e) {
+        placeholder.Nullify();
+    }
+    
+    // The worker meshes a topology-only copy: BRepMesh writes triangulations into the
+    // faces it meshes, and the document shape stays readable on this thread meanwhile
+    // (property panel, booleans, picking, save). Geometry is shared read-only
+    TessellationJob job;
+    job.placeholder = placeholder;
+    try {
+        BRepBuilderAPI_Copy copier(shape->GetOCCTShape(), Standard_False, Standard_False);
+        job.meshCopy = std::make_shared<cad_core::Shape>(copier.Shape());
+        
+        TopTools_IndexedMapOfShape faces;
+        TopTools_IndexedMapOfShape edges;
+        TopExp::MapShapes(shape->GetOCCTShape(), TopAbs_FACE, faces);
+        TopExp::MapShapes(shape->GetOCCTShape(), TopAbs_EDGE, edges);
+        for (int i = 1; i <= faces.Extent(); ++i) {
+            job.faces.emplace_back(faces(i), copier.ModifiedShape(faces(i)));
+        }
+        for (int i = 1; i <= edges.Extent(); ++i) {
+            job.edges.emplace_back(edges(i), copier.ModifiedShape(edges(i)));
+        }
+    } catch (const Standard_Failure&) {
+        job.meshCopy.reset();
+    }
+    
+    cad_core::ShapePtr meshCopy = job.meshCopy;
+    m_tessellationPlaceholders[shape] = std::move(job);
+    if (!meshCopy) {
+        // Could not copy: let AIS mesh on display, as before
+        OnTessellationFinished(nullptr, false);
+        return;
+    }
+    
+    // Same deflection AIS would use, so the shaded presentation reuses this mesh
+    double deflection = DefaultDeflection(shape);
+    double angle = m_context->DefaultDrawer()->DeviationAngle();
+    
+    // The callback runs on a worker thread: hop back to the GUI thread before touching AIS.
+    // Queued calls to a destroyed view are dropped, and the service joins its workers first
+    m_tessellationService->Submit(meshCopy, deflection, angle,
+        [this](const cad_core::ShapePtr& meshedShape, bool success) {
+            QMetaObject::invokeMethod(this, [this, meshedShape, success]() {
+                OnTessellationFinished(meshedShape, success);
+            }, Qt::QueuedConnection);
+        });
+    
+    if (m_displayBatchDepth > 0) {
+        m_batchNeedsFit = true;
+        m_batchNeedsRedraw = true;
+        return;
+    }
+    
+    m_view->FitAll();
+    RequestRedraw();
+}
+
+void QtOccView::OnTessellationFinished(const cad_core::ShapePtr& meshCopy, bool success) {
+    // The shape may have been removed while it was being meshed
+    auto it = std::find_if(m_tessellationPlaceholders.begin(), m_tessellationPlaceholders.end(),
+        [&meshCopy](const std::pair<const cad_core::ShapePtr, TessellationJob>& pair) {
+            return pair.second.meshCopy == meshCopy;
+        });
+    if (it == m_tessellationPlaceholders.end() || m_context.IsNull()) {
+        return;
+    }
+    
+    cad_core::ShapePtr shape = it->first;
+    
+    // On failure AIS simply meshes on display, as before
+    if (success) {
+        AdoptTessellation(it->second);
+    }
+    
+    if (!it->second.placeholder.IsNull()) {
+        m_context->Remove(it->second.placeholder, Standard_False);
+    }
+    m_tessellationPlaceholders.erase(it);
+    
+    Handle(AIS_Shape) aisShape = CreateShapePresentation(shape);
+    m_context->Display(aisShape, Standard_False);
+    m_shapeToAIS[shape] = aisShape;
+    AddPlacement(shape);
+    ActivateShapeSelectionModes(aisShape);
+    
+    RequestRedraw();
+}
+
+void QtOccView::AdoptTessellation(const TessellationJob& job) {
+    // Runs on the GUI thread once the worker is done with the copy: hand its
+    // triangulations and edge polygons over to the document's faces and edges.
+    // Background property jobs read the same faces but never their meshes
+    // (see ShapeProperties::Compute), so swapping them here is safe
+    BRep_Builder builder;
+    for (const auto& pair : job.faces) {
+        TopLoc_Location location;
+        const Handle(Poly_Triangulation)& triangulation =
+            BRep_Tool::Triangulation(TopoDS::Face(pair.second), location);
+        if (!triangulation.IsNull()) {
+            builder.UpdateFace(TopoDS::Face(pair.first), triangulation);
+        }
+    }
+    
+    for (const auto& pair : job.edges) {
+        Handle(BRep_TEdge) source = Handle(BRep_TEdge)::DownCast(pair.second.TShape());
+        Handle(BRep_TEdge) target = Handle(BRep_TEdge)::DownCast(pair.first.TShape());
+        if (source.IsNull() || target.IsNull()) {
+            continue;
+        }
+        
+        // Polygons on the old triangulations are stale now; seam edges carry two per face
+        BRep_ListOfCurveRepresentation& targetCurves = target->ChangeCurves();
+        for (BRep_ListIteratorOfListOfCurveRepresentation it(targetCurves); it.More();) {
+            if (it.Value()->IsPolygonOnTriangulation()) {
+                targetCurves.Remove(it);
+            } else {
+                it.Next();
+            }
+        }
+        for (BRep_ListIteratorOfListOfCurveRepresentation it(source->Curves()); it.More(); it.Next()) {
+            if (it.Value()->IsPolygonOnTriangulation()) {
+                targetCurves.Append(it.Value());
+            }
+        }
+    }
+}
+
+void QtOccView::ActivateShapeSelectionModes(const Handle(AIS_Shape)& aisShape) {
+    // Whole-shape picking is cheap and always on in shape mode. Vertex/edge/face
+    // modes build sensitive entities per sub-shape, so they are only switched on
+    // for shapes under the cursor (see ActivateSubShapeModeAt)
+    if (m_currentSelectionMode == 0) {
+        m_context->SetSelectionModeActive(aisShape, 0, Standard_True); // Shape
+    }
+}
+
+void QtOccView::ActivateSubShapeModeAt(const QPoint& point) {
+    if (m_context.IsNull() || m_view.IsNull() || m_currentSelectionMode == 0) {
+        return;
+    }
+    
+    // Pick ray through the cursor, tested against each shape's cached bounding box
+    Standard_Real X, Y, Z, Vx, Vy, Vz;
+    m_view->ConvertWithProj(point.x(), point.y(), X, Y, Z, Vx, Vy, Vz);
+    gp_Vec direction(Vx, Vy, Vz);
+    if (direction.Magnitude() < gp::Resolution()) {
+        return;
+    }
+    gp_Lin ray(gp_Pnt(X, Y, Z), gp_Dir(direction));
+    
+    // Grow the boxes by a few pixels so edges and vertices on the silhouette still qualify
+    double margin = m_view->Convert(SUB_SHAPE_ACTIVATION_MARGIN_PX + m_context->PixelTolerance());
+    
+    // Shapes owning the current selection keep their mode, so the selection survives
+    std::set<Handle(AIS_InteractiveObject)> selectedObjects;
+    for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
+        selectedObjects.insert(m_context->SelectedInteractive());
+    }
+    
+    for (const auto& pair : m_shapeToAIS) {
+        Bnd_Box box = pair.first->GetBoundingBox();
+        bool underCursor = false;
+        if (!box.IsVoid()) {
+            box.Enlarge(margin);
+            underCursor = !box.IsOut(ray);
+        }
+        
+        bool active = m_subShapeModeShapes.count(pair.first) > 0;
+        if (underCursor && !active) {
+            m_context->SetSelectionModeActive(pair.second, m_currentSelectionMode, Standard_True);
+            m_subShapeModeShapes.insert(pair.first);
+        } else if (!underCursor && active && selectedObjects.count(pair.second) == 0) {
+            // Deactivation alone keeps the computed sensitives; drop them too so only
+            // shapes near the cursor hold vertex/edge/face entities. The full-update
+            // status makes the next activation recompute them
+            m_context->SetSelectionModeActive(pair.second, m_currentSelectionMode, Standard_False);
+            const Handle(SelectMgr_Selection)& selection = pair.second->Selection(m_currentSelectionMode);
+            if (!selection.IsNull()) {
+                selection->Clear();
+                selection->UpdateStatus(SelectMgr_TOU_Full);
+            }
+            m_subShapeModeShapes.erase(pair.first);
+        }
+    }
 }
 QPaintEngine* QtOccView::paintEngine() const
 {
@@ -261,18 +842,39 @@ void QtOccView::RemoveShape(const cad_core::ShapePtr& shape) {
         return;
     }
     
+    // Still being meshed: drop the placeholder and any queued work
+    auto pending = m_tessellationPlaceholders.find(shape);
+    if (pending != m_tessellationPlaceholders.end()) {
+        if (!pending->second.placeholder.IsNull()) {
+            m_context->Remove(pending->second.placeholder, Standard_False);
+        }
+        m_tessellationService->Cancel(pending->second.meshCopy);
+        m_tessellationPlaceholders.erase(pending);
+    }
+    
+    m_subShapeModeShapes.erase(shape);
+    m_previewOriginalTransforms.erase(shape);
+    CancelLevelMeshes(shape);
+    
     // Find and remove the AIS_Shape
     auto it = m_shapeToAIS.find(shape);
     if (it != m_shapeToAIS.end()) {
         Handle(AIS_Shape) aisShape = it->second;
         if (!aisShape.IsNull()) {
             m_context->Remove(aisShape, Standard_False);
+            ReleaseInstancePresentation(aisShape);
+            m_presentationMoves.erase(aisShape.get());
         }
         m_shapeToAIS.erase(it);
+        RemovePlacement(shape);
+    }
+    
+    if (m_displayBatchDepth > 0) {
+        m_batchNeedsRedraw = true;
+        return;
     }
     
-    m_view->Redraw();
-    update();
+    RequestRedraw();
 }
 
 void QtOccView::ClearShapes() {
@@ -280,13 +882,142 @@ void QtOccView::ClearShapes() {
     
     m_context->RemoveAll(Standard_False);
     m_shapeToAIS.clear(); // Clear the mapping
-    m_view->Redraw();
+    m_placementsByTShape.clear();
+    m_instancePrototypes.clear();
+    m_presentationMoves.clear();
+    m_previewOriginalTransforms.clear();
+    m_previewCopies.clear();
+    m_subShapeModeShapes.clear();
+    m_batchPendingActivation.clear();
+    m_tessellationPlaceholders.clear();
+    m_lodJobs.clear();
+    m_tessellationService->CancelAll();
+    
+    if (m_displayBatchDepth > 0) {
+        m_batchNeedsRedraw = true;
+        return;
+    }
+    
+    RequestRedraw();
+}
+
+bool QtOccView::PreviewShapeTransformation(const cad_core::ShapePtr& shape, const gp_Trsf& transformation) {
+    auto it = m_shapeToAIS.find(shape);
+    if (it == m_shapeToAIS.end() || it->second.IsNull() || m_context.IsNull()) {
+        return false;
+    }
+    
+    // Remember the object's own transformation (instances have one) the first time
+    auto original = m_previewOriginalTransforms.find(shape);
+    if (original == m_previewOriginalTransforms.end()) {
+        original = m_previewOriginalTransforms.emplace(shape, it->second->LocalTransformation()).first;
+    }
+    
+    // Only the structure transform changes: no geometry, no meshing, no re-activation
+    it->second->SetLocalTransformation(transformation * original->second);
+    RequestRedraw();
+    return true;
+}
+
+bool QtOccView::AddShapePreviewCopy(const cad_core::ShapePtr& shape, const gp_Trsf& placement) {
+    auto it = m_shapeToAIS.find(shape);
+    if (it == m_shapeToAIS.end() || it->second.IsNull() || m_context.IsNull()) {
+        return false;
+    }
+    
+    // A connected object draws the original's presentation again under another transform
+    Handle(AIS_ConnectedInteractive) copy = new AIS_ConnectedInteractive();
+    copy->Connect(it->second, placement * it->second->LocalTransformation());
+    copy->SetTransparency(0.5);
+    
+    // Display without any selection mode: previews must not be pickable
+    m_context->Display(copy, AIS_Shaded, -1, Standard_False);
+    m_previewCopies.push_back(copy);
+    RequestRedraw();
+    return true;
+}
+
+void QtOccView::ClearShapePreviews() {
+    if (m_context.IsNull()) {
+        m_previewOriginalTransforms.clear();
+        m_previewCopies.clear();
+        return;
+    }
+    
+    if (m_previewOriginalTransforms.empty() && m_previewCopies.empty()) {
+        return;
+    }
+    
+    for (const auto& pair : m_previewOriginalTransforms) {
+        auto it = m_shapeToAIS.find(pair.first);
+        if (it != m_shapeToAIS.end() && !it->second.IsNull()) {
+            it->second->SetLocalTransformation(pair.second);
+        }
+    }
+    m_previewOriginalTransforms.clear();
+    
+    for (const auto& copy : m_previewCopies) {
+        m_context->Remove(copy, Standard_False);
+    }
+    m_previewCopies.clear();
+    
+    RequestRedraw();
+}
+
+bool QtOccView::MoveShapePresentation(const cad_core::ShapePtr& oldShape, const cad_core::ShapePtr& newShape) {
+    if (!oldShape || !newShape || m_context.IsNull() ||
+        oldShape->GetOCCTShape().TShape() != newShape->GetOCCTShape().TShape()) {
+        return false;
+    }
+    
+    // Still meshing: the pending job is keyed by the old shape, let the caller redisplay
+    auto it = m_shapeToAIS.find(oldShape);
+    if (it == m_shapeToAIS.end() || it->second.IsNull() ||
+        m_tessellationPlaceholders.count(oldShape) > 0) {
+        return false;
+    }
+    Handle(AIS_Shape) aisShape = it->second;
+    
+    auto preview = m_previewOriginalTransforms.find(oldShape);
+    if (preview != m_previewOriginalTransforms.end()) {
+        aisShape->SetLocalTransformation(preview->second);
+        m_previewOriginalTransforms.erase(preview);
+    }
+    
+    // Divided keeps the datum the transform command created, so picked sub-shapes
+    // moved by it are IsSame with the sub-shapes of the new document shape
+    TopLoc_Location delta = newShape->GetOCCTShape().Location().Divided(oldShape->GetOCCTShape().Location());
+    TopLoc_Location& move = m_presentationMoves[aisShape.get()];
+    move = delta * move;
+    aisShape->SetLocalTransformation(delta.Transformation() * aisShape->LocalTransformation());
+    
+    // Re-key everything tracked per document shape
+    m_shapeToAIS.erase(it);
+    m_shapeToAIS[newShape] = aisShape;
+    RemovePlacement(oldShape);
+    AddPlacement(newShape);
+    if (m_subShapeModeShapes.erase(oldShape) > 0) {
+        m_subShapeModeShapes.insert(newShape);
+    }
+    for (auto& job : m_lodJobs) {
+        if (job.second.shape == oldShape) {
+            job.second.shape = newShape;
+        }
+    }
+    
+    RequestRedraw();
+    return true;
+}
+
+bool QtOccView::IsShapeDisplayed(const cad_core::ShapePtr& shape) const {
+    return shape && (m_shapeToAIS.find(shape) != m_shapeToAIS.end() ||
+                     m_tessellationPlaceholders.find(shape) != m_tessellationPlaceholders.end());
 }
 
 void QtOccView::RedrawAll() {
     if (m_view.IsNull()) return;
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::SetBackgroundColor(const QColor& color) {
@@ -294,7 +1025,7 @@ void QtOccView::SetBackgroundColor(const QColor& color) {
     
     Quantity_Color occColor(color.redF(), color.greenF(), color.blueF(), Quantity_TOC_RGB);
     m_view->SetBackgroundColor(occColor);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::SetBackgroundGradient(const QColor& color1, const QColor& color2) {
@@ -303,8 +1034,8 @@ void QtOccView::SetBackgroundGradient(const QColor& color1, const QColor& color2
     Quantity_Color occColor1(color1.redF(), color1.greenF(), color1.blueF(), Quantity_TOC_RGB);
     Quantity_Color occColor2(color2.redF(), color2.greenF(), color2.blueF(), Quantity_TOC_RGB);
     
-    m_view->SetBgGradientColors(occColor1, occColor2, Aspect_GFM_VER, Standard_True);
-    m_view->Redraw();
+    m_view->SetBgGradientColors(occColor1, occColor2, Aspect_GFM_VER, Standard_False);
+    RequestRedraw();
 }
 
 void QtOccView::SetSelectionMode(int mode) {
@@ -330,24 +1061,23 @@ void QtOccView::SetSelectionMode(int mode) {
     
     // Clear all existing selection modes
     m_context->Deactivate();
+    m_subShapeModeShapes.clear();
     
-    // Activate the specific selection mode
+    // Activate the specific selection mode. Sub-shape modes are activated lazily,
+    // per shape, when the cursor is over it
     switch (mode) {
         case 0: // Shape
             m_context->Activate(0, Standard_True);
             qDebug() << "Activated shape selection mode";
             break;
         case 1: // Vertex  
-            m_context->Activate(1, Standard_True);
-            qDebug() << "Activated vertex selection mode";
+            qDebug() << "Vertex selection mode, activated on demand";
             break;
         case 2: // Edge
-            m_context->Activate(2, Standard_True);
-            qDebug() << "Activated edge selection mode";
+            qDebug() << "Edge selection mode, activated on demand";
             break;
         case 4: // Face
-            m_context->Activate(4, Standard_True);
-            qDebug() << "Activated face selection mode";
+            qDebug() << "Face selection mode, activated on demand";
             break;
         default:
             m_context->Activate(0, Standard_True); // Default to shape selection
@@ -356,7 +1086,7 @@ void QtOccView::SetSelectionMode(int mode) {
             break;
     }
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ClearSelection() {
@@ -374,8 +1104,8 @@ void QtOccView::ClearSelection() {
     UnhighlightAllVertices();
     UnhighlightAllFaces();
     
-    m_context->ClearSelected(Standard_True);
-    m_view->Redraw();
+    m_context->ClearSelected(Standard_False);
+    RequestRedraw();
 }
 
 void QtOccView::ShowGrid(bool show) {
@@ -386,7 +1116,7 @@ void QtOccView::ShowGrid(bool show) {
     } else {
         m_viewer->DeactivateGrid();
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::SetGridSpacing(double spacing) {
@@ -396,7 +1126,7 @@ void QtOccView::SetGridSpacing(double spacing) {
     // In a real implementation, you'd set the grid spacing properly
     Q_UNUSED(spacing);
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ShowAxes(bool show) {
@@ -407,7 +1137,7 @@ void QtOccView::ShowAxes(bool show) {
     } else {
         m_view->TriedronErase();
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::paintEvent(QPaintEvent* event) {
@@ -425,8 +1155,10 @@ void QtOccView::paintEvent(QPaintEvent* event) {
     }
     
     if (!m_view.IsNull()) {
-        // Only redraw, avoid window remapping which can cause flicker
-        m_view->Redraw();
+        // Only redraw, avoid window remapping which can cause flicker.
+        // Exposed contents must be repainted now, together with anything already pending
+        m_frameScheduler->RequestRedraw();
+        m_frameScheduler->RenderNow();
     }
 }
 
@@ -476,19 +1208,11 @@ void QtOccView::mousePressEvent(QMouseEvent* event) {
 void QtOccView::mouseMoveEvent(QMouseEvent* event) {
     if (m_view.IsNull()) return;
     
-    // 发射鼠标位置信号（屏幕坐标）
+    // 鼠标位置信号和悬停拾取合并到每帧一次（见 OnHoverTimer）
     QPoint currentPos = event->pos();
-    emit MousePositionChanged(currentPos.x(), currentPos.y());
-    
-    // 尝试获取3D世界坐标
-    try {
-        // 将屏幕坐标转换为3D世界坐标
-        Standard_Real X, Y, Z;
-        m_view->Convert(currentPos.x(), currentPos.y(), X, Y, Z);
-        emit Mouse3DPositionChanged(X, Y, Z);
-    } catch (...) {
-        // 如果3D转换失败，使用屏幕坐标
-        emit Mouse3DPositionChanged(currentPos.x(), currentPos.y(), 0.0);
+    m_pendingHoverPos = currentPos;
+    if (!m_hoverTimer->isActive()) {
+        m_hoverTimer->start(m_frameScheduler->GetFrameInterval());
     }
     
     // 优先处理草图模式
@@ -500,19 +1224,19 @@ void QtOccView::mouseMoveEvent(QMouseEvent* event) {
     if (m_currentMouseButton == Qt::LeftButton) {
         // Rotate - use absolute position for rotation
         m_view->Rotation(currentPos.x(), currentPos.y());
-        m_view->Redraw();  // 确保实时渲染
+        RequestRedraw();  // 确保实时渲染
     } else if (m_currentMouseButton == Qt::MiddleButton) {
         // Pan - use delta for panning
         QPoint delta = currentPos - m_lastMousePos;
         m_view->Pan(delta.x(), -delta.y());
-        m_view->Redraw();  // 确保实时渲染
+        RequestRedraw();  // 确保实时渲染
     } else if (m_currentMouseButton == Qt::RightButton) {
         // Zoom - use delta for zooming
         QPoint delta = currentPos - m_lastMousePos;
         if (delta.y() != 0) {
             double factor = (delta.y() > 0) ? 0.9 : 1.1;
             m_view->SetZoom(factor);
-            m_view->Redraw();  // 确保实时渲染
+            RequestRedraw();  // 确保实时渲染
         }
     }
     
@@ -538,7 +1262,7 @@ void QtOccView::wheelEvent(QWheelEvent* event) {
     const double factor = (delta > 0) ? 1.1 : 0.9;
     
     m_view->SetZoom(factor);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::keyPressEvent(QKeyEvent* event) {
@@ -569,11 +1293,71 @@ void QtOccView::InitializeOCC() {
 }
 
 void QtOccView::RedrawView() {
-    if (!m_view.IsNull()) {
-        m_view->Redraw();
+    RequestRedraw();
+}
+
+void QtOccView::RequestRedraw() {
+    // Scene or camera changed: the cached hover bounds are no longer valid on screen
+    InvalidateHover();
+    m_frameScheduler->RequestRedraw();
+}
+
+void QtOccView::RequestImmediateRedraw() {
+    m_frameScheduler->RequestImmediateRedraw();
+}
+
+const FrameStats& QtOccView::GetFrameStats() const {
+    return m_frameScheduler->GetFrameStats();
+}
+
+void QtOccView::OnHoverTimer() {
+    if (m_view.IsNull()) return;
+    
+    const QPoint pos = m_pendingHoverPos;
+    
+    // 发射鼠标位置信号（屏幕坐标）
+    emit MousePositionChanged(pos.x(), pos.y());
+    
+    // 尝试获取3D世界坐标
+    try {
+        // 将屏幕坐标转换为3D世界坐标
+        Standard_Real X, Y, Z;
+        m_view->Convert(pos.x(), pos.y(), X, Y, Z);
+        emit Mouse3DPositionChanged(X, Y, Z);
+    } catch (...) {
+        // 如果3D转换失败，使用屏幕坐标
+        emit Mouse3DPositionChanged(pos.x(), pos.y(), 0.0);
+    }
+    
+    // Sketch tools and view navigation do their own thing; only plain hovering picks
+    if (!IsInSketchMode() && m_currentMouseButton == Qt::NoButton) {
+        UpdateHover(pos);
     }
 }
 
+void QtOccView::UpdateHover(const QPoint& point) {
+    if (m_context.IsNull()) return;
+    
+    // No screen-box early-out: a solid's projected box also covers holes, inside
+    // corners and smaller objects in front of it. The per-frame throttle bounds the cost
+    ActivateSubShapeModeAt(point);
+    
+    // Pick without updating the viewer; the scheduler repaints only the immediate layer
+    m_context->MoveTo(point.x(), point.y(), m_view, Standard_False);
+    
+    Handle(SelectMgr_EntityOwner) owner = m_context->HasDetected()
+        ? m_context->DetectedOwner() : Handle(SelectMgr_EntityOwner)();
+    if (owner != m_hoverOwner) {
+        RequestImmediateRedraw();
+    }
+    
+    m_hoverOwner = owner;
+}
+
+void QtOccView::InvalidateHover() {
+    m_hoverOwner.Nullify();
+}
+
 void QtOccView::HandleSelection(const QPoint& point) {
     if (m_context.IsNull()) return;
     
@@ -593,15 +1377,18 @@ void QtOccView::HandleSelection(const QPoint& point) {
         m_context->ClearSelected(Standard_False);
     }
     
+    // Make sure the shape under the click has the current sub-shape mode active
+    ActivateSubShapeModeAt(point);
+    
     // Perform selection at click point
-    m_context->MoveTo(point.x(), point.y(), m_view, Standard_True);
+    m_context->MoveTo(point.x(), point.y(), m_view, Standard_False);
     
     if (m_context->HasDetected()) {
         if (m_currentSelectionMode == 2) { // Edge mode
             // Handle edge selection for fillet/chamfer operations
             qDebug() << "Edge selection mode detected, attempting to select edge...";
             
-            m_context->Select(Standard_True);
+            m_context->Select(Standard_False);
             
             // Get selected edges from OpenCASCADE context
             int selectedCount = 0;
@@ -630,7 +1417,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
                     // Get the selected entity (edge)
                     Handle(StdSelect_BRepOwner) anOwner = Handle(StdSelect_BRepOwner)::DownCast(m_context->SelectedOwner());
                     if (!anOwner.IsNull()) {
-                        TopoDS_Shape selectedShape = anOwner->Shape();
+                        TopoDS_Shape selectedShape = OwnerShapeInModelSpace(anOwner);
                         qDebug() << "Selected shape type:" << selectedShape.ShapeType() << "TopAbs_EDGE=" << TopAbs_EDGE;
                         
                         if (selectedShape.ShapeType() == TopAbs_EDGE) {
@@ -671,7 +1458,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
             // Handle vertex selection
             qDebug() << "Vertex selection mode detected, attempting to select vertex...";
             
-            m_context->Select(Standard_True);
+            m_context->Select(Standard_False);
             
             // Get selected vertex from OpenCASCADE context
             for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
@@ -682,7 +1469,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
                     // Get the selected entity (vertex)
                     Handle(StdSelect_BRepOwner) anOwner = Handle(StdSelect_BRepOwner)::DownCast(m_context->SelectedOwner());
                     if (!anOwner.IsNull()) {
-                        TopoDS_Shape selectedShape = anOwner->Shape();
+                        TopoDS_Shape selectedShape = OwnerShapeInModelSpace(anOwner);
                         qDebug() << "Selected shape type:" << selectedShape.ShapeType() << "TopAbs_VERTEX=" << TopAbs_VERTEX;
                         
                         if (selectedShape.ShapeType() == TopAbs_VERTEX) {
@@ -701,7 +1488,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
             // Handle face selection for sketch mode
             qDebug() << "Face selection mode detected, attempting to select face...";
             
-            m_context->Select(Standard_True);
+            m_context->Select(Standard_False);
             
             // Get selected face from OpenCASCADE context
             for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
@@ -712,7 +1499,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
                     // Get the selected entity (face)
                     Handle(StdSelect_BRepOwner) anOwner = Handle(StdSelect_BRepOwner)::DownCast(m_context->SelectedOwner());
                     if (!anOwner.IsNull()) {
-                        TopoDS_Shape selectedShape = anOwner->Shape();
+                        TopoDS_Shape selectedShape = OwnerShapeInModelSpace(anOwner);
                         qDebug() << "Selected shape type:" << selectedShape.ShapeType() << "TopAbs_FACE=" << TopAbs_FACE;
                         
                         if (selectedShape.ShapeType() == TopAbs_FACE) {
@@ -752,8 +1539,8 @@ void QtOccView::HandleSelection(const QPoint& point) {
                 
                 if (foundShape) {
                     // Set new selection with highlighting
-                    m_context->SetSelected(aisShape, Standard_True);
-                    m_context->HilightSelected(Standard_True);
+                    m_context->SetSelected(aisShape, Standard_False);
+                    m_context->HilightSelected(Standard_False);
                     m_currentSelectedAIS = aisShape;
                     m_currentSelectedShape = foundShape;
                     
@@ -783,19 +1570,19 @@ void QtOccView::HandleSelection(const QPoint& point) {
     }
     
     // Force redraw to show selection highlighting
-    m_view->Redraw();
+    RequestRedraw();
     emit ViewChanged();
 }
 
-void QtOccView::OnRedrawTimer() {
-    RedrawView();
-}
-
 // 选择模式设置
 void QtOccView::SetSelectionMode(cad_core::SelectionMode mode) {
     if (m_selectionManager) {
         m_selectionManager->SetSelectionMode(mode);
     }
+    
+    // The manager deactivated everything; lazy activation starts over in the new mode
+    m_currentSelectionMode = static_cast<int>(mode);
+    m_subShapeModeShapes.clear();
 }
 
 // 获取选择结果
@@ -856,7 +1643,14 @@ void QtOccView::leaveEvent(QEvent* event) {
     QWidget::leaveEvent(event);
     
     // Don't perform any heavy operations on mouse leave
-    // This prevents flicker when mouse leaves the widget
+    // This prevents flicker when mouse leaves the widget.
+    // Only drop the hover highlight, which lives in the immediate layer
+    m_hoverTimer->stop();
+    if (!m_context.IsNull() && !IsInSketchMode() && m_context->HasDetected()) {
+        m_context->ClearDetected(Standard_False);
+        RequestImmediateRedraw();
+    }
+    InvalidateHover();
 }
 
 void QtOccView::showEvent(QShowEvent* event) {
@@ -871,7 +1665,7 @@ void QtOccView::showEvent(QShowEvent* event) {
     // Minimal redraw when widget is shown - only if necessary
     if (!m_view.IsNull()) {
         m_view->MustBeResized();
-        m_view->Redraw();
+        RequestRedraw();
     }
 }
 
@@ -886,8 +1680,7 @@ void QtOccView::changeEvent(QEvent* event) {
         
         if (!m_view.IsNull() && !m_context.IsNull()) {
             // Force maintain viewer state regardless of activation
-            m_context->UpdateCurrentViewer();
-            m_view->Redraw();
+            RequestRedraw();
         }
     }
 }
@@ -917,7 +1710,7 @@ void QtOccView::SelectShape(const cad_core::ShapePtr& shape) {
             m_currentSelectedShape = shape;
             
             // Redraw to show selection
-            m_view->Redraw();
+            RequestRedraw();
         }
     }
 }
@@ -934,7 +1727,7 @@ void QtOccView::ClearEdgeSelection() {
     m_highlightedEdges.clear();
     m_edgeParentShapes.clear();
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 std::map<cad_core::ShapePtr, std::vector<TopoDS_Edge>> QtOccView::GetSelectedEdgesByShape() const {
@@ -968,7 +1761,7 @@ void QtOccView::HighlightEdge(const TopoDS_Edge& edge) {
     m_context->Display(aisEdge, Standard_False);
     m_highlightedEdges.push_back(aisEdge);
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::UnhighlightAllEdges() {
@@ -980,7 +1773,7 @@ void QtOccView::UnhighlightAllEdges() {
     }
     
     m_highlightedEdges.clear();
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::HighlightVertex(const TopoDS_Vertex& vertex) {
@@ -1011,7 +1804,7 @@ void QtOccView::HighlightVertex(const TopoDS_Vertex& vertex) {
         qDebug() << "Added vertex to selection, total vertices:" << m_selectedVertices.size();
     }
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::UnhighlightAllVertices() {
@@ -1024,7 +1817,7 @@ void QtOccView::UnhighlightAllVertices() {
     
     m_highlightedVertices.clear();
     m_selectedVertices.clear();
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::HighlightFace(const TopoDS_Face& face) {
@@ -1056,7 +1849,7 @@ void QtOccView::HighlightFace(const TopoDS_Face& face) {
         qDebug() << "Added face to selection, total faces:" << m_selectedFaces.size();
     }
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::UnhighlightAllFaces() {
@@ -1069,7 +1862,7 @@ void QtOccView::UnhighlightAllFaces() {
     
     m_highlightedFaces.clear();
     m_selectedFaces.clear();
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 // =============================================================================
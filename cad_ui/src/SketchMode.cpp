@@ -21,6 +21,7 @@
 #include <Graphic3d_Camera.hxx>
 #include <Geom_Circle.hxx>
 #include <gp_Ax2.hxx>
+#include <gp_Vec.hxx>
 
 
 namespace cad_ui {
@@ -372,6 +373,10 @@ double SketchCircleTool::CalculateRadius(const gp_Pnt& center, const gp_Pnt& poi
 SketchMode::SketchMode(QtOccView* viewer, QObject* parent)
     : QObject(parent), m_viewer(viewer), m_isActive(false), m_activeTool(ActiveTool::None){
     
+    m_dragTimer = new QTimer(this);
+    m_dragTimer->setSingleShot(true);
+    connect(m_dragTimer, &QTimer::timeout, this, &SketchMode::OnDragTimer);
+    
     // 创建绘制工具
     m_rectangleTool = std::make_unique<SketchRectangleTool>(this);
 	m_lineTool = std::make_unique<SketchLineTool>(this);
@@ -473,6 +478,13 @@ void SketchMode::ExitSketchMode() {
         return;
     }
 
+    if (m_dragPoint) {
+        m_dragTimer->stop();
+        m_currentSketch->EndPointDrag();
+        m_dragPoint.reset();
+        m_dragDisplays.clear();
+    }
+
     StopCurrentTool();
     RestoreView();
 
@@ -481,8 +493,7 @@ void SketchMode::ExitSketchMode() {
         for (const auto& pair : m_displayedElements) {
             pair.second->SetColor(Quantity_NOC_GRAY50);
         }
-        m_viewer->GetContext()->UpdateCurrentViewer();
-        m_viewer->GetView()->Redraw();
+        m_viewer->RequestRedraw();
     }
 
     // 发射信号，移交管理权 
@@ -552,7 +563,10 @@ void SketchMode::StopCurrentTool() {
 void SketchMode::HandleMousePress(QMouseEvent* event) {
     if (!m_isActive || event->button() != Qt::LeftButton) return;
 
-    if (m_activeTool == ActiveTool::Rectangle) {
+    if (m_activeTool == ActiveTool::None) {
+        BeginPointDrag(event->pos());
+    }
+    else if (m_activeTool == ActiveTool::Rectangle) {
         m_rectangleTool->StartDrawing(event->pos());
     }
     else if (m_activeTool == ActiveTool::Line) { 
@@ -566,7 +580,14 @@ void SketchMode::HandleMousePress(QMouseEvent* event) {
 void SketchMode::HandleMouseMove(QMouseEvent* event) {
     if (!m_isActive) return;
 
-    if (m_activeTool == ActiveTool::Rectangle) {
+    if (m_dragPoint) {
+        // 高回报率鼠标每帧会来好几个事件，只求解最后一个位置
+        m_pendingDragPos = event->pos();
+        if (!m_dragTimer->isActive()) {
+            m_dragTimer->start(m_viewer->GetFrameScheduler()->GetFrameInterval());
+        }
+    }
+    else if (m_activeTool == ActiveTool::Rectangle) {
         m_rectangleTool->UpdateDrawing(event->pos());
     }
     else if (m_activeTool == ActiveTool::Line) { 
@@ -580,7 +601,10 @@ void SketchMode::HandleMouseMove(QMouseEvent* event) {
 void SketchMode::HandleMouseRelease(QMouseEvent* event) {
     if (!m_isActive || event->button() != Qt::LeftButton) return;
 
-    if (m_activeTool == ActiveTool::Rectangle) {
+    if (m_dragPoint) {
+        FinishPointDrag(event->pos());
+    }
+    else if (m_activeTool == ActiveTool::Rectangle) {
         m_rectangleTool->FinishDrawing(event->pos());
     }
     else if (m_activeTool == ActiveTool::Line) { 
@@ -672,7 +696,7 @@ void SketchMode::UpdateCirclePreview(const cad_sketch::SketchCirclePtr& previewC
         }
     }
 
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 void SketchMode::OnDrawingCancelled() {
@@ -680,6 +704,144 @@ void SketchMode::OnDrawingCancelled() {
     emit statusMessageChanged("绘制已取消");
 }
 
+void SketchMode::OnDragTimer() {
+    if (m_dragPoint) {
+        DragPointTo(m_pendingDragPos);
+    }
+}
+
+// 屏幕坐标 -> 草图平面2D坐标（视线与草图平面求交）
+bool SketchMode::ScreenToSketch(const QPoint& screenPoint, double& x, double& y) const {
+    if (!m_viewer || m_viewer->GetView().IsNull()) {
+        return false;
+    }
+
+    Standard_Real Xp, Yp, Zp, Xv, Yv, Zv;
+    m_viewer->GetView()->Convert(screenPoint.x(), screenPoint.y(), Xp, Yp, Zp);
+    m_viewer->GetView()->Proj(Xv, Yv, Zv);
+
+    gp_Dir normal = m_sketchPlane.Axis().Direction();
+    gp_Vec direction(Xv, Yv, Zv);
+    double denominator = direction.Dot(gp_Vec(normal));
+    if (std::abs(denominator) < 1e-12) {
+        return false;  // 视线与草图平面平行
+    }
+
+    gp_Pnt origin(Xp, Yp, Zp);
+    double t = gp_Vec(origin, m_sketchPlane.Location()).Dot(gp_Vec(normal)) / denominator;
+    ElSLib::Parameters(m_sketchPlane, origin.Translated(direction * t), x, y);
+    return true;
+}
+
+// 找到屏幕上离光标最近的草图点（线段端点、圆心、独立点）
+cad_sketch::SketchPointPtr SketchMode::FindPointNear(const QPoint& screenPoint) const {
+    if (!m_currentSketch || !m_viewer || m_viewer->GetView().IsNull()) {
+        return nullptr;
+    }
+
+    cad_sketch::SketchPointPtr nearest;
+    double nearestDistance = DRAG_PICK_RADIUS_PX;
+    auto consider = [&](const cad_sketch::SketchPointPtr& point) {
+        if (!point) {
+            return;
+        }
+        gp_Pnt world = ElSLib::Value(point->GetX(), point->GetY(), m_sketchPlane);
+        Standard_Integer px, py;
+        m_viewer->GetView()->Convert(world.X(), world.Y(), world.Z(), px, py);
+        double distance = std::hypot(px - screenPoint.x(), py - screenPoint.y());
+        if (distance <= nearestDistance) {
+            nearestDistance = distance;
+            nearest = point;
+        }
+    };
+
+    for (const auto& element : m_currentSketch->GetElements()) {
+        switch (element->GetType()) {
+        case cad_sketch::SketchElementType::Point:
+            consider(std::static_pointer_cast<cad_sketch::SketchPoint>(element));
+            break;
+        case cad_sketch::SketchElementType::Line: {
+            auto line = std::static_pointer_cast<cad_sketch::SketchLine>(element);
+            consider(line->GetStartPoint());
+            consider(line->GetEndPoint());
+            break;
+        }
+        case cad_sketch::SketchElementType::Circle:
+            consider(std::static_pointer_cast<cad_sketch::SketchCircle>(element)->GetCenter());
+            break;
+        case cad_sketch::SketchElementType::Arc:
+            consider(std::static_pointer_cast<cad_sketch::SketchArc>(element)->GetCenter());
+            break;
+        }
+    }
+    return nearest;
+}
+
+bool SketchMode::BeginPointDrag(const QPoint& screenPoint) {
+    cad_sketch::SketchPointPtr point = FindPointNear(screenPoint);
+    if (!point || !m_currentSketch->BeginPointDrag(point)) {
+        return false;
+    }
+
+    m_dragPoint = point;
+    m_pendingDragPos = screenPoint;
+
+    // 拖动期间只刷新会随之变化的元素
+    m_dragDisplays.clear();
+    for (const auto& [element, aisShape] : m_displayedElements) {
+        if (m_currentSketch->IsAffectedByDrag(element)) {
+            m_dragDisplays.emplace_back(element, aisShape);
+        }
+    }
+    return true;
+}
+
+void SketchMode::DragPointTo(const QPoint& screenPoint) {
+    double x, y;
+    if (!m_currentSketch || !ScreenToSketch(screenPoint, x, y)) {
+        return;
+    }
+
+    m_currentSketch->DragPointTo(x, y);
+    RefreshDraggedElements();
+}
+
+void SketchMode::FinishPointDrag(const QPoint& screenPoint) {
+    m_dragTimer->stop();
+    DragPointTo(screenPoint);
+
+    bool solved = m_currentSketch->EndPointDrag();
+    RefreshDraggedElements();
+
+    m_dragPoint.reset();
+    m_dragDisplays.clear();
+
+    if (!solved) {
+        emit statusMessageChanged("约束无法全部满足");
+    }
+}
+
+void SketchMode::RefreshDraggedElements() {
+    if (!m_viewer || m_viewer->GetContext().IsNull()) return;
+
+    for (const auto& [element, aisShape] : m_dragDisplays) {
+        TopoDS_Edge edge;
+        if (element->GetType() == cad_sketch::SketchElementType::Line) {
+            edge = ConvertLineToEdge(std::static_pointer_cast<cad_sketch::SketchLine>(element));
+        }
+        else if (element->GetType() == cad_sketch::SketchElementType::Circle) {
+            edge = ConvertCircleToEdge(std::static_pointer_cast<cad_sketch::SketchCircle>(element));
+        }
+        if (edge.IsNull()) {
+            continue;
+        }
+        aisShape->SetShape(edge);
+        m_viewer->GetContext()->Redisplay(aisShape, Standard_False);
+    }
+
+    m_viewer->RequestRedraw();
+}
+
 void SketchMode::SetupSketchPlane(const TopoDS_Face& face) {
     m_sketchPlane = ExtractPlaneFromFace(face);
     CreateSketchCoordinateSystem();
@@ -728,8 +890,8 @@ void SketchMode::SetupSketchView() {
         view->FitAll(0.01, Standard_False);
         view->ZFitAll();
 
-        // 强制重绘
-        view->Redraw();
+        // 请求重绘
+        m_viewer->RequestRedraw();
 
         qDebug() << "Setup sketch view completed:";
         qDebug() << "  Eye:" << eyePosition.X() << eyePosition.Y() << eyePosition.Z();
@@ -877,8 +1039,7 @@ void SketchMode::DisplaySketchCircle(const cad_sketch::SketchCirclePtr& circle)
         m_viewer->GetContext()->Display(aisShape, Standard_False);
     }
 
-    m_viewer->GetContext()->UpdateCurrentViewer();
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 // 清除预览图形
@@ -890,7 +1051,7 @@ void SketchMode::ClearPreviewDisplay() {
     m_previewElements.clear();
 
     // 通知查看器内容已更新
-    m_viewer->GetContext()->UpdateCurrentViewer();
+    m_viewer->RequestRedraw();
 }
 
 // 更新预览图形
@@ -915,7 +1076,7 @@ void SketchMode::UpdatePreview(const std::vector<cad_sketch::SketchLinePtr>& pre
     }
 
     // 在所有对象都添加完毕后，手动触发一次重绘
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 // 显示最终的草图元素
@@ -950,8 +1111,7 @@ void SketchMode::DisplaySketchElement(const cad_sketch::SketchElementPtr& elemen
     }
     // 未来可以在这里添加对 Arc 等其他类型的显示支持
 
-    m_viewer->GetContext()->UpdateCurrentViewer();
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 // 清除所有草图显示（退出时使用）
@@ -962,7 +1122,7 @@ void SketchMode::ClearAllSketchDisplay() {
         m_viewer->GetContext()->Remove(val, Standard_False);
     }
     m_displayedElements.clear();
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 } // namespace cad_ui
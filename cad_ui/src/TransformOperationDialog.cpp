@@ -89,6 +89,28 @@ void TransformOperationDialog::setupUI() {
     
     m_mainLayout->addWidget(m_transformTabs);
     
+    // 复制/阵列：保留原对象，按变换依次生成副本
+    m_copyGroup = new QGroupBox("复制", this);
+    QHBoxLayout* copyLayout = new QHBoxLayout(m_copyGroup);
+    m_copyCheckBox = new QCheckBox("保留原对象并生成副本", m_copyGroup);
+    m_copyCheckBox->setChecked(false);
+    copyLayout->addWidget(m_copyCheckBox);
+    copyLayout->addWidget(new QLabel("副本数量:", m_copyGroup));
+    m_copyCount = new QSpinBox(m_copyGroup);
+    m_copyCount->setRange(1, 10000);
+    m_copyCount->setValue(1);
+    m_copyCount->setEnabled(false);
+    copyLayout->addWidget(m_copyCount);
+    copyLayout->addStretch();
+    m_mainLayout->addWidget(m_copyGroup);
+    
+    connect(m_copyCheckBox, &QCheckBox::toggled, [this](bool checked) {
+        m_copyCount->setEnabled(checked);
+        onTransformTypeChanged();
+    });
+    connect(m_copyCount, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &TransformOperationDialog::onTransformTypeChanged);
+    
     // 控制按钮
     m_buttonLayout = new QHBoxLayout();
     m_buttonLayout->setSpacing(8);
@@ -670,9 +692,21 @@ void TransformOperationDialog::resetAllParameters() {
     m_scaleFactorX->setValue(1.0);
     m_scaleFactorY->setValue(1.0);
     m_scaleFactorZ->setValue(1.0);
+    
+    // 重置复制参数
+    m_copyCheckBox->setChecked(false);
+    m_copyCount->setValue(1);
 }
 
 std::shared_ptr<cad_core::TransformCommand> TransformOperationDialog::getCurrentTransformCommand() const {
+    auto command = createTransformCommand();
+    if (command && m_copyCheckBox->isChecked()) {
+        command->SetCopyCount(m_copyCount->value());
+    }
+    return command;
+}
+
+std::shared_ptr<cad_core::TransformCommand> TransformOperationDialog::createTransformCommand() const {
     if (m_selectedObjects.empty()) {
         return nullptr;
     }